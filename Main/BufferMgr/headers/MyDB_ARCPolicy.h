@@ -0,0 +1,71 @@
+
+#ifndef ARC_POLICY_H
+#define ARC_POLICY_H
+
+#include <list>
+#include <mutex>
+#include "MyDB_ReplacementPolicy.h"
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ARC (adaptive replacement cache) of Megiddo and Modha: the buffered pages are split
+// between T1, the pages that have been used once recently, and T2, the pages that
+// have been used at least twice.  The ids of pages recently kicked out of each are
+// remembered in B1 and B2, and a page that comes back while it is remembered moves
+// the target size of T1 (p) in its favor... so the split between recency and
+// frequency adapts to the workload.  Uses of the same page one right after the
+// other count as one use
+class MyDB_ARCPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	MyDB_ARCPolicy (size_t maxFrames, size_t numFrames, size_t ringFrames);
+
+protected:
+
+	void admitPage (size_t frame, size_t fileId, size_t pageNo) override;
+	void touchPage (size_t frame) override;
+	void removePage (size_t frame) override;
+	long findPageVictim (function <bool (size_t)> &claim) override;
+	void resized () override;
+
+private:
+
+	// tries to kick out the least recently used page from T1 or T2 that can be claimed;
+	// its id is remembered in the matching ghost list
+	long claimFrom (list <size_t> &fromMe, list <size_t> &ghosts, function <bool (size_t)> &claim);
+
+	// forgets the least recently kicked out page in the ghost list
+	void forget (list <size_t> &ghosts);
+
+	// the buffered pages, most recently used first
+	list <size_t> t1;
+	list <size_t> t2;
+
+	// the remembered pages, most recently kicked out first, and which of the two
+	// lists each one is in (and where)
+	list <size_t> b1;
+	list <size_t> b2;
+	unordered_map <size_t, pair <list <size_t> *, list <size_t> :: iterator>> ghostPages;
+
+	// which list each frame is in (a nullptr if none), and where it is in there
+	vector <list <size_t> *> which;
+	vector <list <size_t> :: iterator> where;
+
+	// the page in each frame
+	vector <size_t> keys;
+
+	// the target size for T1
+	double p;
+
+	// the frame that was used last
+	long lastTouched;
+
+	// protects everything
+	mutex latch;
+};
+
+#endif
+
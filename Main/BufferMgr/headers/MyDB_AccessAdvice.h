@@ -0,0 +1,15 @@
+
+#ifndef ACCESS_ADVICE_H
+#define ACCESS_ADVICE_H
+
+// this lists the ways that a table can be accessed... the buffer manager uses these
+// hints to decide how much to read ahead of the pages that are actually asked for
+//
+// NormalAccess: read ahead whenever the buffer manager notices a sequential scan
+// SequentialAccess: the table is going to be scanned, so always read ahead, further
+// RandomAccess: never read ahead
+// WillNeedAccess: the whole table is going to be needed soon, so start reading it now
+enum MyDB_AccessAdvice {NormalAccess, SequentialAccess, RandomAccess, WillNeedAccess};
+
+#endif
+
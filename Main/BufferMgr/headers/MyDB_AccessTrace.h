@@ -0,0 +1,78 @@
+
+#ifndef ACCESS_TRACE_H
+#define ACCESS_TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the number of entries that a trace keeps in RAM before writing them to its file
+#define TRACE_BUFFER_ENTRIES 4096
+
+// what happened to a page in an entry of a trace: its bytes were asked for (TraceRead),
+// it was written to (TraceWrite), or it was pinned or un-pinned
+enum MyDB_TraceKind {TraceRead, TraceWrite, TracePin, TraceUnpin};
+
+// one entry of a trace; 16 bytes each in the trace file, in the machine's byte order
+struct MyDB_TraceEntry {
+
+	// nanoseconds since the trace was started
+	uint64_t time;
+
+	// the page, given by its position in its file and the id that the buffer manager
+	// gave to the file (id 0 is the temp file; see MyDB_BufferManager.h)
+	uint32_t pageNo;
+	uint16_t fileId;
+
+	// a MyDB_TraceKind
+	uint8_t kind;
+	uint8_t unused;
+};
+
+// records the page accesses made through a buffer manager, if it was asked to (see
+// MyDB_BufferOptions.h), so that they can be played back later against other
+// replacement policies and buffer sizes (see MyDB_TraceSimulator.h).  The file starts
+// with the 8 bytes "MYDBTRC1" and the buffer's page size (8 bytes), followed by the
+// entries, in the order that they were recorded.  Entries are kept in RAM and written
+// TRACE_BUFFER_ENTRIES at a time, and the rest are written when the trace goes away
+class MyDB_AccessTrace {
+
+public:
+
+	// starts a trace in the given file, replacing anything that was there
+	MyDB_AccessTrace (string fileName, size_t pageSize);
+
+	// writes out the entries that have not been written yet
+	~MyDB_AccessTrace ();
+
+	// adds an entry for the page
+	void record (size_t fileId, size_t pageNo, MyDB_TraceKind kind);
+
+	// reads a whole trace file, putting the page size into pageSize and the entries
+	// into entries; returns false if the file can not be read or is not a trace
+	static bool read (string fileName, size_t &pageSize, vector <MyDB_TraceEntry> &entries);
+
+private:
+
+	// writes the entries that are waiting; must be called with the latch held
+	void writeEntries ();
+
+	// the trace file
+	int fd;
+
+	// when the trace was started
+	chrono :: steady_clock :: time_point start;
+
+	// the entries that have not been written yet
+	vector <MyDB_TraceEntry> waiting;
+
+	// protects the file and the entries
+	mutex latch;
+};
+
+#endif
+
@@ -0,0 +1,57 @@
+
+#ifndef BUDDY_ALLOCATOR_H
+#define BUDDY_ALLOCATOR_H
+
+#include <set>
+#include <vector>
+
+using namespace std;
+
+// hands out the frames of the buffer pool in blocks, for pages that are bigger than
+// one frame... a block of order k is 2^k frames that start at a multiple of 2^k (this
+// is Knowlton's buddy system).  A bigger block is split in half as needed to get a
+// smaller one, and when a block is given back, it is joined with its buddy (the other
+// half of the block that it came from) if that is free too, and so on up.  This is not
+// thread safe; the buffer manager only uses it with its pool latch held
+class MyDB_BuddyAllocator {
+
+public:
+
+	// sets up for frames 0, 1, ..., maxFrames - 1, none of which are free yet
+	MyDB_BuddyAllocator (size_t maxFrames);
+
+	// takes the lowest free block of the given order, splitting a bigger one if need
+	// be; returns its first frame, or -1 if there is no free block that big
+	long allocate (int order);
+
+	// gives back the block of the given order that starts at the given frame (which
+	// may also be a frame that was never handed out, such as a new one)
+	void free (size_t frame, int order);
+
+	// returns the order of the free block that starts at the given frame; -1 if there
+	// is none
+	int getFreeOrder (size_t frame);
+
+	// returns the number of frames that are free
+	size_t getNumFree ();
+
+	// returns the order of the biggest block there can be
+	int getMaxOrder ();
+
+	// returns the order of the smallest block holding the given number of frames
+	static int getOrder (size_t numFrames);
+
+private:
+
+	// the free blocks of each order, by first frame
+	vector <set <size_t>> freeBlocks;
+
+	// for each frame, the order of the free block that starts there; -1 if none
+	vector <signed char> freeOrder;
+
+	// the number of free frames
+	size_t numFree;
+};
+
+#endif
+
@@ -13,19 +13,60 @@
 #ifndef BUFFER_MGR_H
 #define BUFFER_MGR_H
 
-#include "CheckLRU.h"
-#include <map>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include "MyDB_AccessTrace.h"
+#include "MyDB_BuddyAllocator.h"
+#include "MyDB_BufferOptions.h"
+#include "MyDB_BufferStats.h"
+#include "MyDB_File.h"
+#include "MyDB_Frame.h"
+#include "MyDB_FrameArena.h"
+#include "MyDB_IOBackend.h"
+#include "MyDB_MemoryGrant.h"
 #include "MyDB_Page.h"
 #include "MyDB_PageHandle.h"
+#include "MyDB_PagePool.h"
+#include "MyDB_PageRange.h"
+#include "MyDB_PageTable.h"
 #include "MyDB_Table.h"
-#include "PageCompare.h"
+#include <mutex>
 #include <queue>
-#include "TableCompare.h"
-#include <set>
+#include <thread>
+#include <unordered_map>
 
 using namespace std;
 
+// the number of latched partitions that the page table and the table -> file id map are split into
+#define NUM_PARTITIONS 16
+
+// the number of background threads that read pages ahead
+#define NUM_IO_WORKERS 2
+
+// the most pages that are read with a single request to the I/O backend
+#define MAX_READ_RUN 64
+
+// the most pages that are written with a single request to the I/O backend
+#define MAX_WRITE_RUN 32
+
+// the most pages that pinRange latches at once (and so reads with a single request)
+#define MAX_PIN_RUN 32
+
+// the alignment of buffers, file offsets, and lengths needed for direct I/O
+#define DIRECT_IO_ALIGNMENT 4096
+
+// the number of temp pages placed by free space between looks at how much free space
+// the spill directories actually have
+#define SPILL_CHECK_INTERVAL 64
+
+// the least time, in milliseconds, that a pin made through a memory grant waits for a
+// frame... there is always one for it, but the pages in the way may be latched for a bit
+#define GRANT_PIN_TIMEOUT 1000
+
+// the name of the pool that anonymous pages go into, if there is one (see addPool)
+#define SPILL_POOL "spill"
+
 class MyDB_BufferManager;
 typedef shared_ptr <MyDB_BufferManager> MyDB_BufferManagerPtr;
 
@@ -49,20 +90,71 @@ public:
 	// between this method and getPage (whicTable, i) is that the page will be 
 	// pinned in RAM; it cannot be written out to the file... note that in Chris'
 	// implementation, a request for a pinned page that is made when the buffer
-	// is ENTIRELY full of pinned pages will return a nullptr
+	// is ENTIRELY full of pinned pages will return a nullptr (unless a pin
+	// timeout has been set; see setPinTimeout)
 	MyDB_PageHandle getPinnedPage (MyDB_TablePtr whichTable, long i);
 
 	// gets a temporary page, like getPage (), except that this one is pinned
 	MyDB_PageHandle getPinnedPage ();
 
+	// gets a temporary page of the given size, which must be the buffer's page size
+	// times a power of two (see getPageSize (whichTable))
+	MyDB_PageHandle getPage (size_t pageSize);
+	MyDB_PageHandle getPinnedPage (size_t pageSize);
+
+	// pins count consecutive pages of the table, starting with page first, all at once:
+	// either all of them are pinned, or (if there are not enough frames for all of them,
+	// even after waiting out the pin timeout) none of them are, and a nullptr is returned.
+	// The pages that are not buffered are read in runs, with one request to the I/O
+	// backend for each run of up to MAX_PIN_RUN of them
+	MyDB_PageRangePtr pinRange (MyDB_TablePtr whichTable, long first, long count);
+
+	// sets aside numFrames frames for the caller, who can then pin pages through the
+	// grant (see MyDB_MemoryGrant.h) knowing that there will be room for them.  Pages
+	// pinned any other way count against the frames that are not set aside, so once a
+	// grant has been made, a pin that would eat into it fails (or waits out the pin
+	// timeout) even if there are frames that are not in use.  Returns a nullptr if there
+	// are not that many frames that are neither set aside nor holding pinned pages
+	MyDB_MemoryGrantPtr reserve (size_t numFrames);
+
+	// the most frames that could be set aside right now
+	size_t getReservableFrames ();
+
+	// same as above, but the frames are set aside in the pool that the table's pages go
+	// into (see addPool)
+	MyDB_MemoryGrantPtr reserve (size_t numFrames, MyDB_TablePtr forTable);
+
+	// adds another buffer manager as a pool of its own behind this one, so that a
+	// table can be kept apart from the rest of the buffer: the pages of a table whose
+	// buffer pool (see MyDB_Table.h) is the given name are asked for from that pool
+	// instead of this one, and so they never compete for frames with pages from other
+	// pools.  Tables with no buffer pool (or one that was never added) use this one.
+	// If there is a pool named SPILL_POOL, anonymous pages come from it (and so do
+	// the runs of a sort, which are put in that pool).  Each pool has its own frames,
+	// replacement policy, and stats.  Every pool must have the same page size as this
+	// one.  Since the pools are not latched, they must all be added before the buffer
+	// is shared: once this manager (or the pool being added) has handed out a page, no
+	// more pools can be added.  Returns false (and does nothing) if the pool can not
+	// be added
+	bool addPool (string name, MyDB_BufferManagerPtr pool);
+
+	// returns the pool with the given name; a nullptr if there is no such pool
+	MyDB_BufferManagerPtr getPool (string name);
+
 	// un-pins the specified page
 	void unpin (MyDB_PagePtr unpinMe);
 
-	// creates an LRU buffer manager... params are as follows:
+	// creates a buffer manager... params are as follows:
 	// 1) the size of each page is pageSize 
 	// 2) the number of pages managed by the buffer manager is numPages;
 	// 3) temporary pages are written to the file tempFile
-	MyDB_BufferManager (size_t pageSize, size_t numPages, string tempFile);
+	// 4) the policy used to pick which page to evict (see MyDB_ReplacementPolicy.h);
+	//    by default, the CLOCK algorithm (an approximation of LRU)
+	MyDB_BufferManager (size_t pageSize, size_t numPages, string tempFile, 
+		MyDB_ReplacementType replacement = ClockReplacement);
+
+	// same as above, but with all of the other choices (see MyDB_BufferOptions.h)
+	MyDB_BufferManager (size_t pageSize, size_t numPages, string tempFile, MyDB_BufferOptions options);
 	
 	// when the buffer manager is destroyed, all of the dirty pages need to be
 	// written back to disk, and any temporary files need to be deleted
@@ -70,51 +162,404 @@ public:
 
 	// returns the page size
 	size_t getPageSize ();
+
+	// returns the size of the table's pages... a table can ask for bigger pages than
+	// the buffer's (see MyDB_Table.h), as long as they are the buffer's page size times
+	// a power of two, and no bigger than the buffer can ever be.  Such a page takes up
+	// a block of adjacent frames, which are found with a buddy allocator; if there is no
+	// free block, the pages in the block around the page that the replacement policy
+	// picks are kicked out along with it
+	size_t getPageSize (MyDB_TablePtr whichTable);
+
+	// the buffer manager may be used by many threads at once.  By default, a request
+	// that needs a frame when every frame holds a pinned page fails right away (a
+	// nullptr is returned for a pinned page).  When several threads share the pool,
+	// some other thread is likely to let go of a page soon, and so setting a timeout
+	// makes such requests wait up to that many milliseconds for a frame first
+	void setPinTimeout (long timeoutInMs);
+
+	// note that with several threads, only a pinned page's bytes are safe to use
+	// after a call to getBytes (), since an unpinned page can be kicked out at any
+	// time by another thread that needs a frame
 	
+	// asks for pages firstPage, firstPage + 1, ..., firstPage + numPages - 1 of the
+	// table to be read into the buffer in the background, so that they are there
+	// by the time that they are needed.  Runs of pages that are not buffered are
+	// read with a single big read.  Reading ahead only ever kicks out pages that
+	// nobody has a handle to, and it gives up if there are no such pages
+	void prefetch (MyDB_TablePtr whichTable, long firstPage, long numPages);
+
+	// tells the buffer manager how the table is going to be accessed (see
+	// MyDB_AccessAdvice.h).  By default, the buffer manager starts reading ahead
+	// whenever it sees that a table's pages are being asked for in order.  Pages
+	// that are read as part of such a scan are kept in a small ring of frames of
+	// their own, so that a big scan does not flush the rest of the buffer
+	void adviseAccess (MyDB_TablePtr whichTable, MyDB_AccessAdvice advice);
+
+	// returns the number of pages that have been read from disk so far, including
+	// the ones that were read ahead
+	size_t getNumReads ();
+
+	// returns the RAM for the buffer pool, so that its setup time and the huge pages
+	// actually in use can be checked
+	MyDB_FrameArena &getArena ();
+
+	// returns the thing doing all of the file I/O, so that the kind actually in use can be checked
+	MyDB_IOBackend &getIOBackend ();
+
+	// returns true if the table's file is read and written with direct I/O
+	bool usesDirectIO (MyDB_TablePtr whichTable);
+
+	// returns a snapshot of everything that the buffer manager has counted so far
+	// (see MyDB_BufferStats.h)... the counting is cheap enough to always be on, except
+	// for the I/O latencies, which are only kept if asked for (see MyDB_BufferOptions.h)
+	MyDB_BufferStats getStats ();
+
+	// adds n frames to the buffer, while it is in use; returns false (and does nothing)
+	// if that would be more than the most pages that the buffer can hold (see
+	// MyDB_BufferOptions.h)
+	bool grow (size_t n);
+
+	// takes n frames away from the buffer, while it is in use... free frames go first,
+	// and then the pages that the replacement policy would kick out next (which are
+	// written back if they are dirty).  Returns false if there are not n frames that
+	// do not hold pinned pages, if the frames are needed for memory grants, or if the
+	// buffer would be left with no frames at all; the buffer keeps its size in that
+	// case, though some pages may have been kicked out
+	bool shrink (size_t n);
+
+	// returns the number of frames that the buffer has right now
+	size_t getNumPages ();
+
+	// writes every dirty page in the buffer back to its file, without kicking any
+	// of them out... the pages are written in file order, with runs of adjacent
+	// dirty pages written together
+	void flush ();
+
+
 private:
 
-	// tells us the LRU number of each of the pages
-	set <MyDB_PagePtr, CheckLRU> lastUsed;
+	// all of the frames that the buffer pool could ever have, and their RAM
+	vector <MyDB_Frame> frames;
+	unique_ptr <MyDB_FrameArena> arena;
+
+	// does all of the reading and writing of files
+	MyDB_IOBackendPtr ioBackend;
+
+	// decides which frame to take a page out of when a new page needs one; it is
+	// told about every frame that is filled, used, or emptied
+	MyDB_ReplacementPolicyPtr policy;
+
+	// the number of pages read from disk, and the bytes read and written
+	atomic <size_t> numReads;
+	atomic <size_t> bytesRead;
+	atomic <size_t> bytesWritten;
 
-	// list of ALL of the page objects that are currently in existence
-	map <pair <MyDB_TablePtr, size_t>, MyDB_PagePtr, PageCompare> allPages;
+	// the rest of the counts for the stats (the hits and misses are kept for each
+	// file; see MyDB_File.h)
+	atomic <size_t> evictions;
+	atomic <size_t> dirtyWriteBacks;
+	atomic <size_t> pinFailures;
+
+	// how long reads and writes take, if trackLatency is set
+	bool trackLatency;
+	MyDB_LatencyCounters readLatency;
+	MyDB_LatencyCounters writeLatency;
+
+	// whether files should be opened for direct I/O
+	bool directIO;
+
+	// where the page objects come from; this has to outlive all of them
+	MyDB_PagePool pagePool;
+
+	// list of ALL of the (non-anonymous) page objects that are currently in existence,
+	// partitioned by the hash of (file id, page number)
+	MyDB_PagePartition allPages[NUM_PARTITIONS];
 	
-	// lists the FDs for all of the files
-	map <MyDB_TablePtr, int, TableCompare> fds;
+	// all of the files that we have seen, indexed by file id; file 0 is the temp file
+	// for anonymous pages of the buffer's page size
+	vector <MyDB_File> files;
 
-	// all of the chunks of RAM that are currently not allocated
-	vector <void *> availableRam;
+	// the file id given to each table object the first time that it was used,
+	// partitioned by the address of the table object
+	MyDB_FilePartition fileIds[NUM_PARTITIONS];
 
-	// all of the positions in the temporary file that are currently not in use
-	priority_queue<size_t, vector<size_t>, greater<size_t>> availablePositions;
+	// the file id given to each table name... different table objects with the same
+	// name refer to the same file
+	unordered_map <string, size_t> fileIdsByName;
 
-	// the page size
-	size_t pageSize;
+	// the files that are open, the one used most recently first, and the most that may be
+	// (there can be more for a bit if they are all being read or written)
+	list <size_t> openFiles;
+	size_t maxOpenFiles;
+
+	// the number of times that a file was opened
+	size_t fileOpens;
+
+	// protects files, fileIdsByName, and the list of open files
+	mutex filesLatch;
+
+	// all of the frames that currently do not hold a page
+	unique_ptr <MyDB_BuddyAllocator> freeFrames;
+
+	// the frames that were taken away by shrinking; the lowest ones are used first
+	// when the buffer grows again, before any frames at or above frameLimit
+	priority_queue <size_t, vector <size_t>, greater <size_t>> retiredFrames;
+
+	// one past the highest frame that has ever been used, and the most frames there can be
+	size_t frameLimit;
+	size_t maxPages;
+
+	// protects the frames' page pointers, the replacement policy, the lists of available
+	// and retired frames, and the number of buffer pages
+	mutex poolLatch;
+
+	// signalled (with the pool latch held) whenever a frame might have become available
+	condition_variable frameFreed;
+
+	// how long a request for a frame waits when all of the frames are pinned
+	long pinTimeout;
+
+	// protects the temp files and the spill directories' free space
+	mutex tempLatch;
+
+	// the temp file for each order of anonymous page (see MyDB_BuddyAllocator.h) in
+	// each spill directory
+	vector <vector <MyDB_TempFile>> tempFiles;
 
-	// the time tick associated with the MRU page
-	long lastTimeTick;
+	// the name of the temp file in each spill directory; if no spill directories were
+	// given, there is just the one temp file
+	vector <string> spillFiles;
+	vector <string> spillDirs;
 
-	// the last position in the temporary file
-	size_t lastTempPos;
+	// how temp pages are spread over the spill directories, the next one to get a page
+	// for round robin, and the free space in each (as of the last check, less what has
+	// been put there since)
+	MyDB_SpillPlacement spillPlacement;
+	size_t nextSpill;
+	vector <size_t> spillSpace;
+	size_t spillChecks;
 
-	// where we write the data
+	// the page size
+	size_t pageSize;
+
+	// where we write the data; the temp files for bigger pages have the page size
+	// tacked onto the end of this
 	string tempFile;
 
 	// the number of buffer pages
 	size_t numPages;
 
+	// how many pages past the page that triggered it a read-ahead goes
+	long readAheadPages;
+
+	// the background threads that read pages ahead; started the first time that
+	// there is something to read
+	vector <thread> ioWorkers;
+
+	// the pages waiting to be read ahead
+	deque <MyDB_PrefetchRequest> prefetchRequests;
+
+	// protects the list of requests and the list of workers
+	mutex prefetchLatch;
+
+	// signalled when there is a new request, or it is time for the workers to stop
+	condition_variable prefetchReady;
+
+	// set when the buffer manager is going away
+	atomic <bool> shuttingDown;
+
+	// the frames set aside for memory grants, and the frames holding pages that were
+	// pinned other than through a grant (or through a grant that has since gone away)...
+	// protected by the pool latch
+	size_t reservedFrames;
+	size_t pinnedFrames;
+
+	// where the buffered pages are listed when the buffer manager goes away; empty if nowhere
+	string residentFile;
+
+	// where page accesses are recorded, if they are
+	unique_ptr <MyDB_AccessTrace> trace;
+
+	// the pools added behind this one, by name, and the one that anonymous pages come
+	// from (this one, if there is no SPILL_POOL)
+	unordered_map <string, MyDB_BufferManagerPtr> pools;
+	MyDB_BufferManager *spillPool;
+
+	// set once a page has been asked for, after which the pools are fixed
+	atomic <bool> inUse;
+
+	// the background thread that keeps frames free, if there is one
+	thread cleaner;
+
+	// the number of free frames that the cleaner tries to keep
+	size_t cleanFrames;
+
+	// signalled (with the pool latch held) when the cleaner should go to work
+	condition_variable cleanerWake;
+
 	// so that the page can access these private methods
 	friend class MyDB_Page;
+	friend class MyDB_MemoryGrant;
 	friend class SortMergeJoin;
 
-	// kick out the LRU page
-	void kickOutPage ();
+	// asks the replacement policy for a frame holding an unpinned page that nobody
+	// else has latched.  If unreferencedOnly is set, pages that someone has a handle
+	// to are skipped as well.  The page's
+	// frame is returned, and the page is taken out of the frame and left latched.
+	// Must be called with the pool latch held.  Returns -1 if there is no such page
+	long findVictim (bool unreferencedOnly);
+
+	// takes the page in the frame away from the frame, as findVictim does, if it can;
+	// must be called with the pool latch held
+	bool claimPage (size_t whichFrame, bool unreferencedOnly);
+
+	// called when a page needs a block of the given order that is not free... claims
+	// the pages in the block holding the given frame (which is the one the policy
+	// picked, or -1 if we are going on with a block that was already started), up to
+	// a batch of them.  Nothing is claimed if some frame in the block can not be
+	// emptied.  Must be called with the pool latch held
+	void claimBlock (size_t whichFrame, int order, long picked, bool unreferencedOnly, vector <long> &victimFrames);
+
+	// returns the order of the block of frames that a page of the given size needs;
+	// -1 if that is not a size that the buffer can hold
+	int getOrder (size_t size);
+
+	// writes the (latched) page back if needed, now that its frame has been taken
+	// away, unlatches it, and gets rid of it if there are no more references to it
+	void kickOutPage (MyDB_Page *kickMe);
+
+	// gets a block of frames for the given page, which must be latched, kicking out
+	// pages if necessary; returns -1 if there is no block available because the pages
+	// in the way are pinned.  The caller reads the page's bytes in and then sets the page's frame.
+	// A background request only kicks out unreferenced pages and never waits.  If
+	// fromScan is set, the page goes into the replacement policy's ring for scans.  If
+	// granted is set, the page is being pinned through a memory grant, and so there is
+	// a frame for it somewhere; we wait at least GRANT_PIN_TIMEOUT for it
+	long getFrame (MyDB_Page *forMe, bool background = false, bool fromScan = false, bool granted = false);
+
+	// makes sure that the page has a frame and pins it there, counting it against the
+	// grant (if it is not a nullptr); false if no frame
+	bool pinPage (MyDB_Page *pinMe, const MyDB_GrantFramesPtr &grant);
+
+	// the public methods of the same names, pinning through the grant (if it is not a nullptr)
+	MyDB_PageHandle getPinnedPage (MyDB_TablePtr whichTable, long i, const MyDB_GrantFramesPtr &grant);
+	MyDB_PageHandle getPinnedPage (size_t pageSize, const MyDB_GrantFramesPtr &grant);
+	MyDB_PageRangePtr pinRange (MyDB_TablePtr whichTable, long first, long count, const MyDB_GrantFramesPtr &grant);
+
+	// counts the (latched) page, which is about to be pinned, against the grant, or if
+	// that is a nullptr, against the frames that are not set aside (waiting out the pin
+	// timeout for room if need be); false if there is no room for it
+	bool chargePin (MyDB_Page *pinMe, const MyDB_GrantFramesPtr &grant);
+
+	// takes back the charge for the (latched) page, which is being un-pinned
+	void unchargePin (MyDB_Page *unpinMe);
+
+	// called when a grant goes away; its frames are no longer set aside, and the pages
+	// still pinned through it count against the rest of the buffer from now on
+	void releaseGrant (const MyDB_GrantFramesPtr &releaseMe);
+
+	// lets anyone waiting on a frame know that one might be available
+	void signalFrameFreed ();
+
+	// process an access to the given page; returns the page's bytes, or nullptr if it is not
+	// buffered and every frame holds a pinned page (even after waiting out the pin timeout)
+	void *access (MyDB_Page *updateMe);
+
+	// finds the partition of the page table holding the given page
+	MyDB_PagePartition &getPartition (size_t fileId, size_t pageNo);
+
+	// removes an unreferenced page from the page table; the (latched) page is
+	// returned so that the caller can destroy it after unlatching it
+	MyDB_PagePtr erasePage (MyDB_Page *eraseMe);
+
+	// returns the pool that the table's pages go into
+	MyDB_BufferManager *getPoolFor (const MyDB_TablePtr &forMe);
 
-	// process an access to the given page
-	void access (MyDB_PagePtr updateMe);
+	// gets the file id for the table, registering the table if it has never been seen
+	size_t getFileId (const MyDB_TablePtr &forMe);
+
+	// gets the fd for the file, opening it if it is not open, and keeps it open until
+	// doneWithFd is called for it (each call to useFd needs a call to doneWithFd)
+	int useFd (size_t fileId);
+	void doneWithFd (size_t fileId);
+
+	// tells the kernel how the (open) file is going to be accessed; must be called with
+	// the files latch held
+	void adviseKernel (MyDB_File &file);
+
+	// gets the counts for the file
+	MyDB_FileCounters *getCounters (size_t fileId);
+
+	// adds the time since start to the histogram, if latencies are being kept
+	void addLatency (MyDB_LatencyCounters &addTo, chrono :: steady_clock :: time_point start);
+
+	// read/write the page's bytes from/to its spot in its file
+	void readPage (MyDB_Page *readMe);
+	void writePage (MyDB_Page *writeMe);
+
+	// gets an anonymous page of the given size from this pool (see getPage (size))
+	MyDB_PageHandle getTempPage (size_t size);
 
 	// removes all traces of the page from the buffer manager
-	void killPage (MyDB_PagePtr killMe);
+	void killPage (MyDB_Page *killMe);
+
+	// picks the spill directory for a new anonymous page of the given order; must be
+	// called with the temp latch held
+	size_t pickSpillDir (int order);
+
+	// gives the (anonymous, unlatched) page's spot in its temp file back... if the page
+	// was ever written, its bytes are punched out of the file, and if the end of the
+	// file is no longer in use, the file is cut short
+	void freeTempPos (MyDB_Page *freeMe);
+
+	// true if the page, which is about to be read in, looks like it is part of a scan
+	bool isScanning (MyDB_Page *readMe);
+
+	// called after the page had to be read in (or a page that was read ahead was
+	// accessed); decides whether to read ahead of the page, and if so, asks for it
+	void readAhead (MyDB_Page *justRead, bool markWasSet);
+
+	// hands a request over to the background workers, starting them if needed
+	void queuePrefetch (MyDB_PrefetchRequest &request);
+
+	// the loop run by each of the background workers
+	void prefetchWorker ();
+
+	// latches the page and gives it a frame to be read into, creating the page if
+	// necessary... returns a nullptr if the page is already buffered or is busy; sets
+	// outOfFrames if there was no frame to give it
+	MyDB_PagePtr startPrefetch (MyDB_PrefetchRequest &request, long pos, long &whichFrame, bool &outOfFrames);
+
+	// the loop run by the cleaner
+	void cleanerLoop ();
+
+	// empties the frames, which were just picked as victims, and finishes kicking out
+	// their (latched) pages, writing back the dirty ones in file order... then the
+	// frames are given back to the buddy allocator
+	void evictFrames (vector <long> &victimFrames);
+
+	// the size of the ring for scanned pages for the current number of buffer pages
+	size_t getRingFrames ();
+
+	// writes the pages, which must be sorted by file and position and must not be
+	// changing... each run of consecutive pages in the same file is one request, and
+	// all of the requests are handed to the I/O backend at once
+	void writePages (vector <MyDB_Page *> &writeMe);
+
+	// orders pages by where they are on disk
+	static bool inFileOrder (MyDB_Page *lhs, MyDB_Page *rhs);
+
+	// lists the table pages that are buffered in the resident file, hottest first
+	void saveResidentPages ();
+
+	// asks for the hottest pages listed in the resident file (as many as fit) to be read
+	// ahead, creating a table object for each of their tables
+	void prewarm ();
+
+	// reads a run of consecutive, latched pages (paired with the frames that they
+	// are going into) with one request, then publishes their frames and unlatches them
+	void readRun (int fd, vector <pair <MyDB_PagePtr, long>> &run, long markPage);
 
 };
 
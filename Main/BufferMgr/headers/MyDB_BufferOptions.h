@@ -0,0 +1,96 @@
+
+#ifndef BUFFER_OPTIONS_H
+#define BUFFER_OPTIONS_H
+
+#include "MyDB_FrameArena.h"
+#include "MyDB_IOBackend.h"
+#include "MyDB_ReplacementPolicy.h"
+#include "MyDB_SpillPlacement.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the choices that can be made when a buffer manager is created; the defaults are
+// set up by the constructor, so only the interesting ones need to be changed
+struct MyDB_BufferOptions {
+
+	// the policy used to pick which page to evict (see MyDB_ReplacementPolicy.h)
+	MyDB_ReplacementType replacement;
+
+	// how the RAM for the buffer pool is backed (see MyDB_FrameArena.h)
+	MyDB_HugePages hugePages;
+
+	// whether all of the RAM is touched when the buffer manager is created, rather
+	// than the first time each frame is used
+	bool prefault;
+
+	// whether files are opened with O_DIRECT, so that pages are not cached a second
+	// time by the kernel.  This needs a page size that is a multiple of 4KB, and is
+	// quietly not done otherwise, or for files on file systems that do not allow it
+	bool directIO;
+
+	// how the files are read and written (see MyDB_IOBackend.h)
+	MyDB_IOBackendType ioBackend;
+
+	// the most pages that the buffer can be grown to hold (see MyDB_BufferManager :: grow);
+	// 0 means four times as many as it starts out with.  Room for this many pages is set
+	// aside in the address space up front, but it only takes RAM once it is used
+	size_t maxPages;
+
+	// whether the time taken by every read and write is kept track of, for the I/O
+	// latency histograms in the stats (see MyDB_BufferStats.h)
+	bool trackLatency;
+
+	// the number of free frames that a background cleaner thread tries to keep ready,
+	// by kicking out unreferenced pages (writing back the dirty ones, in file order)
+	// before anyone needs their frames; 0 means that there is no cleaner
+	size_t cleanFrames;
+
+	// the directories that temp pages are written to.  By default there are none, and
+	// temp pages go into the temp file given to the buffer manager; otherwise, each
+	// directory gets a temp file of its own (with the same name as that one), and the
+	// temp pages are spread over them as spillPlacement says (see MyDB_SpillPlacement.h)
+	vector <string> spillDirs;
+	MyDB_SpillPlacement spillPlacement;
+
+	// the most files that are kept open at once... when another file needs to be opened,
+	// the one that was used least recently (and is not being read or written right now)
+	// is closed, and it is opened again the next time that it is needed
+	size_t maxOpenFiles;
+
+	// if this is not empty, every page access is recorded in a trace file of this name
+	// (see MyDB_AccessTrace.h), which can be played back later to see how other
+	// replacement policies and buffer sizes would have done (see MyDB_TraceSimulator.h)
+	string traceFile;
+
+	// if this is not empty, the table pages that are buffered when the buffer manager
+	// goes away are listed in a file of this name, hottest first (that is, in the
+	// opposite order to the one that the replacement policy would kick them out in).
+	// If prewarm is also set, a new buffer manager starts reading the hottest pages on
+	// that list back in, in the background, as soon as it is created, a run of
+	// consecutive pages at a time; it can be used while that is going on
+	string residentFile;
+	bool prewarm;
+
+	MyDB_BufferOptions () {
+		replacement = ClockReplacement;
+		hugePages = NoHugePages;
+		prefault = false;
+		directIO = false;
+		cleanFrames = 0;
+		ioBackend = PReadBackend;
+		trackLatency = false;
+		maxPages = 0;
+		spillPlacement = RoundRobinSpill;
+		prewarm = false;
+		maxOpenFiles = 128;
+	}
+
+	MyDB_BufferOptions (MyDB_ReplacementType replacementIn) : MyDB_BufferOptions () {
+		replacement = replacementIn;
+	}
+};
+
+#endif
+
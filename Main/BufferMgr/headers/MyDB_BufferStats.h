@@ -0,0 +1,153 @@
+
+#ifndef BUFFER_STATS_H
+#define BUFFER_STATS_H
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the number of separate counts that a busy counter is split into
+#define NUM_COUNTER_STRIPES 16
+
+// the number of buckets in an I/O latency histogram; bucket i counts the requests
+// that took less than 2^i microseconds (the last one counts everything else)
+#define NUM_LATENCY_BUCKETS 24
+
+// a counter that many threads can bump at once without all fighting over the same
+// cache line: each thread adds to one of several counts, and reading the counter
+// adds them all up
+class MyDB_StripedCounter {
+
+public:
+
+	MyDB_StripedCounter () {
+		for (auto &stripe : stripes)
+			stripe.count = 0;
+	}
+
+	inline void add (size_t howMuch) {
+		stripes[getStripe ()].count.fetch_add (howMuch, memory_order_relaxed);
+	}
+
+	size_t get () {
+		size_t total = 0;
+		for (auto &stripe : stripes)
+			total += stripe.count.load (memory_order_relaxed);
+		return total;
+	}
+
+private:
+
+	// each count gets a cache line of its own
+	struct Stripe {
+		atomic <size_t> count;
+		char padding[64 - sizeof (atomic <size_t>)];
+	};
+	Stripe stripes[NUM_COUNTER_STRIPES];
+
+	// the stripe that this thread uses
+	static size_t getStripe ();
+};
+
+// the live counts that the buffer manager keeps for each file
+struct MyDB_FileCounters {
+
+	// page accesses that found the page buffered
+	MyDB_StripedCounter hits;
+
+	// page accesses that had to read the page in
+	MyDB_StripedCounter misses;
+};
+
+typedef shared_ptr <MyDB_FileCounters> MyDB_FileCountersPtr;
+
+// the live counts for an I/O latency histogram
+struct MyDB_LatencyCounters {
+
+	atomic <size_t> buckets[NUM_LATENCY_BUCKETS];
+	atomic <size_t> count;
+	atomic <size_t> totalMicros;
+
+	MyDB_LatencyCounters () {
+		for (auto &bucket : buckets)
+			bucket = 0;
+		count = 0;
+		totalMicros = 0;
+	}
+
+	// adds a request that took the given number of microseconds
+	void add (size_t micros);
+};
+
+// a snapshot of the hits and misses for one table
+struct MyDB_TableStats {
+	string table;
+	size_t hits;
+	size_t misses;
+};
+
+// a snapshot of an I/O latency histogram; buckets[i] is the number of requests that
+// took less than 2^i microseconds... a read request is one run of pages, and a write
+// request is all of the runs written at once
+struct MyDB_LatencyHistogram {
+	vector <size_t> buckets;
+	size_t count;
+	size_t totalMicros;
+};
+
+// a snapshot of everything that a buffer manager has counted since it was created
+struct MyDB_BufferStats {
+
+	// how the buffer manager was set up
+	size_t pageSize;
+	size_t numPages;
+
+	// page accesses that found the page buffered, and ones that had to read it in
+	size_t hits;
+	size_t misses;
+
+	// pages read from disk (this includes the pages read ahead), and the bytes read and written
+	size_t pagesRead;
+	size_t bytesRead;
+	size_t bytesWritten;
+
+	// pages kicked out of the buffer to make room for other pages
+	size_t evictions;
+
+	// dirty pages written back, whether because they were kicked out, cleaned, or flushed
+	// (these are the only pages that are ever written)
+	size_t dirtyWriteBacks;
+
+	// requests for a pinned page (or range of pages) that failed because every frame was pinned
+	size_t pinFailures;
+
+	// the size of the temp files, in pages (the space of anonymous pages that were let
+	// go is given back, so this shrinks, too)
+	size_t tempPages;
+
+	// the files that are open right now, and the number of times that a file was opened
+	// (files that were closed to keep the number open down are opened again when needed)
+	size_t openFiles;
+	size_t fileOpens;
+
+	// the hits and misses for each table (the temp file is listed as "temp")
+	vector <MyDB_TableStats> tables;
+
+	// the time taken by each read and write, if the buffer manager was asked to keep track
+	bool hasLatencies;
+	MyDB_LatencyHistogram readLatency;
+	MyDB_LatencyHistogram writeLatency;
+
+	// the fraction of page accesses that were hits
+	double hitRate ();
+
+	// writes everything out in the Prometheus text format: one "name{labels} value"
+	// line per number, with all of the names starting with "mydb_buffer_"
+	void dump (ostream &out);
+};
+
+#endif
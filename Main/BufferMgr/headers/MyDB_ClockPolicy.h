@@ -0,0 +1,40 @@
+
+#ifndef CLOCK_POLICY_H
+#define CLOCK_POLICY_H
+
+#include "MyDB_ReplacementPolicy.h"
+#include <vector>
+
+using namespace std;
+
+// the CLOCK algorithm (an approximation of LRU)... the clock hand sweeps over the
+// ring of frames, looking for a page whose reference bit is not set, and clearing
+// the bits that are set as it goes.  Setting the bit is the only thing that a
+// buffer hit does, so hits never take a lock
+class MyDB_ClockPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	MyDB_ClockPolicy (size_t maxFrames, size_t numFrames, size_t ringFrames);
+
+protected:
+
+	void admitPage (size_t frame, size_t fileId, size_t pageNo) override;
+	void touchPage (size_t frame) override;
+	void removePage (size_t frame) override;
+	long findPageVictim (function <bool (size_t)> &claim) override;
+
+private:
+
+	// the reference bit for each frame
+	unique_ptr <atomic <bool> []> refBits;
+
+	// whether each frame holds a page that this policy is looking after
+	vector <bool> present;
+
+	// the next frame that the clock hand will look at
+	size_t clockHand;
+};
+
+#endif
+
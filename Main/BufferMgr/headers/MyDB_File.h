@@ -0,0 +1,124 @@
+
+#ifndef FILE_H
+#define FILE_H
+
+#include "MyDB_AccessAdvice.h"
+#include "MyDB_BufferStats.h"
+#include "MyDB_Table.h"
+#include <list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// everything the buffer manager knows about one of the files that it reads and
+// writes pages from; each file is identified by a small integer (its position
+// in the buffer manager's list of files)
+struct MyDB_File {
+
+	// the table stored in the file; a nullptr for the temporary file
+	MyDB_TablePtr table;
+
+	// where the file lives
+	string fileName;
+
+	// the size of the file's pages
+	size_t pageSize;
+
+	// the file descriptor; -1 if the file is not open (the buffer manager only keeps so
+	// many files open; see MyDB_BufferOptions.h)
+	int fd;
+
+	// the number of reads and writes that are using the file descriptor, which can not
+	// be closed until there are none
+	int fdUsers;
+
+	// whether the file has ever been opened, and where it is in the buffer manager's list
+	// of open files, if it is open
+	bool opened;
+	list <size_t> :: iterator openPos;
+
+	// whether the file was opened for direct I/O
+	bool direct;
+
+	// how the file is expected to be accessed
+	MyDB_AccessAdvice advice;
+
+	// the last page that had to be read in because someone asked for it
+	long lastMiss;
+
+	// the first and last pages in the most recent read-ahead window
+	long readAheadStart;
+	long readAheadEnd;
+
+	// the hits and misses for the file's pages
+	MyDB_FileCountersPtr counters;
+
+	MyDB_File (MyDB_TablePtr tableIn, string fileNameIn, size_t pageSizeIn) {
+		table = tableIn;
+		fileName = fileNameIn;
+		pageSize = pageSizeIn;
+		fd = -1;
+		fdUsers = 0;
+		opened = false;
+		direct = false;
+		advice = NormalAccess;
+		lastMiss = -2;
+		readAheadStart = -2;
+		readAheadEnd = -2;
+		counters = make_shared <MyDB_FileCounters> ();
+	}
+};
+
+// the temporary file for the anonymous pages of one size in one spill directory...
+// each size has a file of its own, so that every page in a file starts at a multiple
+// of its size
+struct MyDB_TempFile {
+
+	// the file's id; -1 if there has never been an anonymous page of this size
+	long fileId;
+
+	// the hits and misses for the file's pages
+	MyDB_FileCounters *counters;
+
+	// the last position in the file, and the positions before it that are currently not
+	// in use (the lowest ones are used first, so that the end of the file can be given back)
+	size_t lastPos;
+	set <size_t> availablePositions;
+
+	MyDB_TempFile () {
+		fileId = -1;
+		counters = nullptr;
+		lastPos = 0;
+	}
+};
+
+// a request to read a range of pages from a file in the background
+struct MyDB_PrefetchRequest {
+
+	// the table and its file
+	MyDB_TablePtr table;
+	size_t fileId;
+
+	// the range of pages to read
+	long firstPage;
+	long numPages;
+
+	// this page is marked once it has been read, and when it is accessed, the next
+	// read-ahead window is requested; -1 if no page should be marked
+	long markPage;
+};
+
+// the buffer manager splits the (table object -> file id) map over a number of
+// partitions, each with its own latch, so that looking up a table's id does not
+// mean taking one global lock
+struct MyDB_FilePartition {
+	mutex latch;
+	unordered_map <MyDB_TablePtr, size_t> fileIds;
+};
+
+#endif
+
@@ -0,0 +1,18 @@
+
+#ifndef FRAME_H
+#define FRAME_H
+
+// forward definition to handle circular dependencies
+class MyDB_Page;
+
+// a frame is one page-sized chunk of the RAM managed by the buffer manager; its
+// RAM is found in the frame arena, at the frame's index
+struct MyDB_Frame {
+
+	// the page that currently lives in this frame; a nullptr if the frame is free...
+	// this is only read or written by someone holding the buffer manager's pool latch
+	MyDB_Page *page;
+};
+
+#endif
+
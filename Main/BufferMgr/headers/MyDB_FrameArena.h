@@ -0,0 +1,69 @@
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+
+using namespace std;
+
+// how the RAM for the buffer pool is backed
+// 
+// NoHugePages: regular pages
+// TransparentHugePages: the region is aligned to a huge page and the kernel is asked
+//	(with MADV_HUGEPAGE) to back it with transparent huge pages where it can
+// ExplicitHugePages: the region is mapped with MAP_HUGETLB, from the kernel's pool of
+//	reserved huge pages; if there are not enough of them, transparent huge pages are
+//	used instead
+enum MyDB_HugePages {NoHugePages, TransparentHugePages, ExplicitHugePages};
+
+// all of the frames in the buffer pool live in one big mmap'ed region; frame i
+// starts i * frameSize bytes into the region, so frames are found by their index.
+// The region has room for all of the frames that the pool could ever grow to, but
+// the kernel only puts RAM behind the parts that are actually used
+class MyDB_FrameArena {
+
+public:
+
+	// maps the region for maxFrames frames of frameSize bytes each, of which the first
+	// numFrames are used right away; if prefault is set, every page of those frames is
+	// touched up front, so that the first use of a frame does not take a page fault
+	MyDB_FrameArena (size_t frameSize, size_t numFrames, size_t maxFrames, MyDB_HugePages hugePages, bool prefault);
+
+	// unmaps the region
+	~MyDB_FrameArena ();
+
+	// returns the RAM for the i^th frame
+	char *getFrame (size_t i) {
+		return base + i * frameSize;
+	}
+
+	// gives the RAM behind the i^th frame back to the kernel... this is done a page
+	// (or an explicit huge page) at a time, so only the pages entirely inside of the
+	// frame are given back
+	void release (size_t i);
+
+	// the huge pages actually in use (the explicit ones may not have been available)
+	MyDB_HugePages getHugePages ();
+
+	// how long it took to set up the region, in seconds
+	double getSetupTime ();
+
+private:
+
+	// the start of the frames, and of the whole mapping (which may have been padded
+	// so that the frames could be aligned)
+	char *base;
+	char *mapping;
+
+	// the size of the mapping
+	size_t mappingSize;
+
+	// the size of each frame
+	size_t frameSize;
+
+	MyDB_HugePages hugePages;
+	double setupTime;
+};
+
+#endif
+
@@ -0,0 +1,65 @@
+
+#ifndef IO_BACKEND_H
+#define IO_BACKEND_H
+
+#include <memory>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <vector>
+
+using namespace std;
+
+// the ways that a buffer manager can read and write its files
+//
+// PReadBackend: every run of pages is read or written with a preadv or pwritev
+// URingBackend: runs are handed to the kernel through io_uring, so that a whole batch
+//	of them (for example, all of the runs written back at once) costs a single system
+//	call; if io_uring is not available, preadv and pwritev are used instead
+// MmapBackend: files are mapped into memory, and pages are read by copying them out
+//	of the mapping, so a page that the kernel has cached is read without any system
+//	call at all; pages are written with pwritev.  This is meant for tables that are
+//	mostly read (note that pages are read through the kernel's page cache even if
+//	the files were opened for direct I/O)
+enum MyDB_IOBackendType {PReadBackend, URingBackend, MmapBackend};
+
+// one read or write of a run of consecutive pages: the run starts offset bytes into
+// the file, and its pages go to (or come from) the numBuffers buffers
+struct MyDB_IORequest {
+	int fd;
+	struct iovec *buffers;
+	int numBuffers;
+	off_t offset;
+};
+
+class MyDB_IOBackend;
+typedef shared_ptr <MyDB_IOBackend> MyDB_IOBackendPtr;
+
+// does all of the buffer manager's file I/O; any number of threads may use it at once
+class MyDB_IOBackend {
+
+public:
+
+	// creates a backend of the given type
+	static MyDB_IOBackendPtr create (MyDB_IOBackendType type);
+
+	// reads the run, returning once it has been read... as with preadv, the part of a
+	// run that is past the end of the file is not filled in
+	virtual void read (MyDB_IORequest &request) = 0;
+
+	// writes all of the runs, returning once they have all been written
+	virtual void write (vector <MyDB_IORequest> &requests) = 0;
+
+	// the buffer manager says when it has opened a file, and when it is about to close one
+	virtual void openedFile (int fd);
+	virtual void closingFile (int fd);
+
+	// and when it has cut a file short (only temp files are ever cut short)
+	virtual void truncatedFile (int fd, size_t size);
+
+	// the type of backend actually in use (io_uring may not have been available)
+	virtual MyDB_IOBackendType getType () = 0;
+
+	virtual ~MyDB_IOBackend ();
+};
+
+#endif
@@ -0,0 +1,64 @@
+
+#ifndef LRUK_POLICY_H
+#define LRUK_POLICY_H
+
+#include <list>
+#include <mutex>
+#include "MyDB_ReplacementPolicy.h"
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// LRU-K, with K = 2: the page whose second-to-last use is the furthest in the
+// past is kicked out first, and pages that have only been used once go before
+// any of the others.  So a page that was touched once by a scan does not look
+// as hot as a page that keeps on being used.  The last two uses of recently
+// kicked out pages are remembered, so a page that comes right back keeps its
+// history.  Uses of the same page one right after the other count as one use
+class MyDB_LRUKPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	MyDB_LRUKPolicy (size_t maxFrames, size_t numFrames, size_t ringFrames);
+
+protected:
+
+	void admitPage (size_t frame, size_t fileId, size_t pageNo) override;
+	void touchPage (size_t frame) override;
+	void removePage (size_t frame) override;
+	long findPageVictim (function <bool (size_t)> &claim) override;
+
+private:
+
+	// the last two uses of a page that is no longer buffered
+	struct History {
+		long last;
+		long prev;
+		list <size_t> :: iterator where;
+	};
+
+	// the last two uses of the page in each frame; 0 if there was no such use
+	vector <long> last;
+	vector <long> prev;
+
+	// the page in each frame
+	vector <size_t> keys;
+
+	// whether each frame holds a page that this policy is looking after
+	vector <bool> present;
+
+	// the histories of kicked out pages, and the order that they were kicked out in
+	unordered_map <size_t, History> ghosts;
+	list <size_t> ghostOrder;
+
+	// the logical clock, and the frame that was used last
+	long now;
+	long lastTouched;
+
+	// protects everything
+	mutex latch;
+};
+
+#endif
+
@@ -0,0 +1,43 @@
+
+#ifndef LRU_POLICY_H
+#define LRU_POLICY_H
+
+#include <list>
+#include <mutex>
+#include "MyDB_ReplacementPolicy.h"
+#include <vector>
+
+using namespace std;
+
+// plain LRU: the page that was used least recently is kicked out first.  Every
+// buffer hit moves its frame to the front of a list, under a latch
+class MyDB_LRUPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	MyDB_LRUPolicy (size_t maxFrames, size_t numFrames, size_t ringFrames);
+
+protected:
+
+	void admitPage (size_t frame, size_t fileId, size_t pageNo) override;
+	void touchPage (size_t frame) override;
+	void removePage (size_t frame) override;
+	long findPageVictim (function <bool (size_t)> &claim) override;
+
+private:
+
+	// the frames, most recently used first
+	list <size_t> lru;
+
+	// where each frame is in the list
+	vector <list <size_t> :: iterator> where;
+
+	// whether each frame is in the list
+	vector <bool> present;
+
+	// protects everything
+	mutex latch;
+};
+
+#endif
+
@@ -0,0 +1,66 @@
+
+#ifndef MEMORY_GRANT_H
+#define MEMORY_GRANT_H
+
+#include <memory>
+#include "MyDB_PageHandle.h"
+#include "MyDB_PageRange.h"
+#include "MyDB_Table.h"
+
+using namespace std;
+
+// forward definition to handle circular dependencies
+class MyDB_BufferManager;
+
+class MyDB_MemoryGrant;
+typedef shared_ptr <MyDB_MemoryGrant> MyDB_MemoryGrantPtr;
+
+// the frames given to a memory grant, and how many of them hold pages pinned through
+// the grant.  This is kept by the grant and by each page pinned through it, since such
+// a page may stay pinned after the grant is gone (its frames then count against the
+// rest of the buffer).  Only used with the buffer manager's pool latch held
+struct MyDB_GrantFrames {
+	size_t numFrames;
+	size_t numPinned;
+	bool released;
+};
+typedef shared_ptr <MyDB_GrantFrames> MyDB_GrantFramesPtr;
+
+// a number of frames set aside for one operator (see MyDB_BufferManager :: reserve).
+// Pages pinned through the grant count against its frames, and pages pinned any other
+// way can not have them, so an operator that stays within its grant knows that its pins
+// will not fail for want of frames (though a pin may have to wait a bit for a frame
+// that is being read into to be let go).  The frames that do not hold pages pinned
+// through the grant are used for caching like any others, and when the grant goes
+// away, they all go back to the rest of the buffer
+class MyDB_MemoryGrant {
+
+public:
+
+	// the number of frames in the grant, and how many of them hold pages pinned through it
+	size_t getNumFrames ();
+	size_t getNumPinned ();
+
+	// the same as the buffer manager's methods of the same names, except that the pages
+	// count against the grant... these return a nullptr if there is not enough room
+	// left in the grant
+	MyDB_PageHandle getPinnedPage (MyDB_TablePtr whichTable, long i);
+	MyDB_PageHandle getPinnedPage ();
+	MyDB_PageHandle getPinnedPage (size_t pageSize);
+	MyDB_PageRangePtr pinRange (MyDB_TablePtr whichTable, long first, long count);
+
+	// gives the frames back to the rest of the buffer
+	~MyDB_MemoryGrant ();
+
+private:
+
+	friend class MyDB_BufferManager;
+
+	MyDB_MemoryGrant (MyDB_BufferManager &parent, size_t numFrames);
+
+	MyDB_BufferManager &parent;
+	MyDB_GrantFramesPtr frames;
+};
+
+#endif
+
@@ -0,0 +1,60 @@
+
+#ifndef MMAP_BACKEND_H
+#define MMAP_BACKEND_H
+
+#include "MyDB_PReadBackend.h"
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+// reads pages by copying them out of a (read-only, shared) mapping of the file, and
+// writes them with pwritev; since the mapping and the writes both go through the
+// kernel's page cache, the mapping always sees what was written.
+//
+// Each file's mapping is made bigger than the file, so that it still covers the file
+// as the file grows.  When the file outgrows it, a mapping twice as big is made; the
+// old one is kept until the file is closed, since some other thread may still be
+// copying out of it.  A file that is cut short is not remapped, but the part of the
+// mapping past its new end is no longer used
+class MyDB_MmapBackend : public MyDB_PReadBackend {
+
+public:
+
+	~MyDB_MmapBackend ();
+
+	void read (MyDB_IORequest &request) override;
+	void closingFile (int fd) override;
+	void truncatedFile (int fd, size_t size) override;
+	MyDB_IOBackendType getType () override;
+
+private:
+
+	// one mapping of a file
+	struct Mapping {
+		char *bytes;
+		size_t size;
+	};
+
+	// all of a file's mappings (the last one is the current one), and how much of
+	// the file is known to exist
+	struct MappedFile {
+		vector <Mapping> mappings;
+		size_t fileSize = 0;
+	};
+
+	// finds the current mapping for the file, making sure that it covers the first
+	// end bytes of the file if it can... returns false if the file is not that big
+	bool getMapping (int fd, size_t end, char *&bytes);
+
+	// unmaps all of the file's mappings
+	void unmap (MappedFile &file);
+
+	// the mapped files, by file descriptor
+	unordered_map <int, MappedFile> files;
+
+	// protects files
+	mutex latch;
+};
+
+#endif
@@ -0,0 +1,20 @@
+
+#ifndef PREAD_BACKEND_H
+#define PREAD_BACKEND_H
+
+#include "MyDB_IOBackend.h"
+
+using namespace std;
+
+// reads and writes each run with a single preadv or pwritev... these do not use the
+// file offset, so threads sharing a file descriptor do not fight over it
+class MyDB_PReadBackend : public MyDB_IOBackend {
+
+public:
+
+	void read (MyDB_IORequest &request) override;
+	void write (vector <MyDB_IORequest> &requests) override;
+	MyDB_IOBackendType getType () override;
+};
+
+#endif
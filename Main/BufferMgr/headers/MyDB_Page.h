@@ -12,24 +12,30 @@
 #ifndef PAGE_H
 #define PAGE_H
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <mutex>
 #include "MyDB_Table.h"
 #include <string>
+#include <utility>
 
-// create a smart pointer for pages
+// pages are reference counted by MyDB_PagePtr (below)
 using namespace std;
 class MyDB_Page;
-typedef shared_ptr <MyDB_Page> MyDB_PagePtr;
+class MyDB_PagePtr;
 
 // forward deifnition to handle circular dependencies
 class MyDB_BufferManager;
+struct MyDB_FileCounters;
+struct MyDB_GrantFrames;
 
 class MyDB_Page {
 
 public:
 
 	// access the raw bytes in this page
-	void *getBytes (MyDB_PagePtr me);
+	void *getBytes ();
 
 	// let the page know that we have written to the bytes
 	void wroteBytes ();
@@ -40,24 +46,28 @@ public:
 	~MyDB_Page ();
 
 	// sets up the page... takes as input the relation that the page is
-	// bound to (this should be a nullptr if this is a temp page) and
-	// the position of the page in the file
-	MyDB_Page (MyDB_TablePtr myTable, size_t i, MyDB_BufferManager &parent);
+	// bound to (this should be a nullptr if this is a temp page), the id
+	// that the buffer manager gave to the relation's file, the position
+	// of the page in the file, and the page's size (along with the order of
+	// the block of frames that it needs; see MyDB_BuddyAllocator.h)
+	MyDB_Page (MyDB_TablePtr myTable, size_t fileId, size_t i, size_t numBytes, int order, MyDB_BufferManager &parent);
 
 	// sets the bytes in the page
 	void setBytes (void *bytes, size_t numBytes);
 
-	// decrements the ref count
-	inline void decRefCount (MyDB_PagePtr me) {
-		refCount--;
-		if (refCount == 0) {
-			killpage (me);
+	// decrements the ref count... the handle going away also lets go of the page object,
+	// but only after the page has been told that it has no more handles
+	inline void decRefCount () {
+		if (refCount.fetch_sub (1) == 1) {
+			killpage ();
 		}
+		release ();
 	}
 
-	// increments the ref count
+	// increments the ref count; a handle also keeps the page object around
 	inline void incRefCount () {
 		refCount++;
+		ptrCount++;
 	}
 
 	// get the parent
@@ -66,8 +76,9 @@ public:
 private:
 
 	friend class MyDB_BufferManager;
+	friend class MyDB_PagePool;
+	friend class MyDB_PagePtr;
 	friend class PageComp;
-	friend class CheckLRU;
 
 	// a pointer to the raw bytes
 	void *bytes;
@@ -75,8 +86,16 @@ private:
 	// the number of raw bytes available
 	size_t numBytes;
 
+	// the page takes up a block of 2^order frames when it is buffered
+	int order;
+
 	// tells us if this page needs to be written back
-	bool isDirty;	
+	atomic <bool> isDirty;	
+
+	// set (with the latch held) once the page's bytes have been written to its file... for
+	// an anonymous page, this means that its spot in the temp file has to be punched out
+	// when it goes away
+	bool onDisk;
 
 	// pointer to the parent buffer manager
 	MyDB_BufferManager& parent;		
@@ -85,17 +104,108 @@ private:
 	// this is a temp page that does not belong to any relation
 	MyDB_TablePtr myTable;
 
+	// this is the id of the file that the page lives in
+	size_t fileId;
+
 	// this is the position of the page in the relation
 	size_t pos;
 
-	// this is the last time that the page had been accessed
-	long timeTick;
+	// the frame in the buffer pool that holds the page's bytes; -1 if none...
+	// this is only set once the bytes have been read in, so that a reader who
+	// sees a frame here can use it without latching the page
+	atomic <long> frame;
+
+	// true if the page cannot be kicked out of the buffer pool
+	atomic <bool> pinned;
+
+	// the number of references (that is, the number of page handles)
+	atomic <int> refCount;
 
-	// the number of references
-	int refCount;
+	// the number of MyDB_PagePtrs and handles that refer to the page object; once
+	// there are none, it goes back to the buffer manager's page pool
+	atomic <int> ptrCount;
+
+	// set on a page that was read ahead; accessing the page starts the next read-ahead
+	atomic <bool> readAheadMark;
+
+	// the hits and misses for the page's file... set (with the latch held) before the
+	// page is first given a frame, and never changed after that
+	MyDB_FileCounters *counters;
+
+	// the memory grant that the page was pinned through, if any (see MyDB_MemoryGrant.h);
+	// set and cleared with the latch and the buffer manager's pool latch held
+	shared_ptr <MyDB_GrantFrames> grant;
+
+	// held while the page is being read in, written out, pinned, or unpinned
+	mutex latch;
 
 	// kill the page
-	void killpage (MyDB_PagePtr me);
+	void killpage ();
+
+	// lets go of one reference to the page object
+	inline void release () {
+		if (ptrCount.fetch_sub (1) == 1)
+			recycle ();
+	}
+
+	// gives the page object back to the page pool
+	void recycle ();
+};
+
+// a reference counted pointer to a page object, which the buffer manager uses to keep
+// the page around.  The count is kept in the page itself, and the page is made by (and
+// given back to) the buffer manager's page pool, so copying one of these is just an
+// atomic increment, and making a page object usually does not touch the heap
+class MyDB_PagePtr {
+
+public:
+
+	MyDB_PagePtr () : page (nullptr) {}
+
+	MyDB_PagePtr (nullptr_t) : page (nullptr) {}
+
+	// takes a reference to the page
+	explicit MyDB_PagePtr (MyDB_Page *usePage) : page (usePage) {
+		if (page != nullptr)
+			page->ptrCount++;
+	}
+
+	MyDB_PagePtr (const MyDB_PagePtr &copyMe) : MyDB_PagePtr (copyMe.page) {}
+
+	MyDB_PagePtr (MyDB_PagePtr &&moveMe) : page (moveMe.page) {
+		moveMe.page = nullptr;
+	}
+
+	// assignment covers both copying and moving
+	MyDB_PagePtr &operator = (MyDB_PagePtr fromMe) {
+		swap (page, fromMe.page);
+		return *this;
+	}
+
+	~MyDB_PagePtr () {
+		if (page != nullptr)
+			page->release ();
+	}
+
+	MyDB_Page *get () const {
+		return page;
+	}
+
+	MyDB_Page *operator -> () const {
+		return page;
+	}
+
+	bool operator == (nullptr_t) const {
+		return page == nullptr;
+	}
+
+	bool operator != (nullptr_t) const {
+		return page != nullptr;
+	}
+
+private:
+
+	MyDB_Page *page;
 };
 
 #endif
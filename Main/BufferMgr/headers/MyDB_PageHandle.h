@@ -13,61 +13,110 @@
 #ifndef PAGE_HANDLE_H
 #define PAGE_HANDLE_H
 
-#include <memory>
+#include <cstddef>
 #include "MyDB_Page.h"
 #include "MyDB_Table.h"
 #include <string>
 
-// page handles are basically smart pointers
+// page handles are basically smart pointers... but they are values, not heap objects:
+// a handle is just a pointer to the page, and the count of handles to a page is kept
+// in the page, so getting a handle to a buffered page does not touch the heap
 using namespace std;
-class MyDB_PageHandleBase;
-typedef shared_ptr <MyDB_PageHandleBase> MyDB_PageHandle;
+class MyDB_PageHandle;
 
+// this is what a page handle points to
 class MyDB_PageHandleBase {
 
 public:
 
-	// access the raw bytes in this page
-	void *getBytes () {
-		return page->getBytes (page);
+	// access the raw bytes in this page... this is a nullptr if the page is not pinned, is not
+	// buffered, and there is no frame to read it into because every one holds a pinned page
+	// (when many threads share the buffer, this is not an error; try again later)
+	void *getBytes () const {
+		return page->getBytes ();
 	}
 
 	// let the page know that we have written to the bytes.  Must always
 	// be called once the page's bytes have been written.  If this is not
 	// called, then the page will never be marked as dirty, and the page
 	// will never be written to disk. 
-	void wroteBytes () {
+	void wroteBytes () const {
 		page->wroteBytes ();
 	}
 
+private:
+
+	friend class MyDB_PageReaderWriter;
+	friend class MyDB_PageHandle;
+
+	// get the buffer manager
+	MyDB_BufferManager &getParent () const {
+		return page->getParent ();
+	}
+
+	friend class MyDB_BufferManager;
+	MyDB_Page *page;
+};
+
+class MyDB_PageHandle {
+
+public:
+
+	// a handle to no page
+	MyDB_PageHandle () {
+		base.page = nullptr;
+	}
+
+	MyDB_PageHandle (nullptr_t) : MyDB_PageHandle () {}
+
+	// copying a handle adds a reference to the page; moving one does not
+	MyDB_PageHandle (const MyDB_PageHandle &copyMe) : MyDB_PageHandle (copyMe.base.page) {}
+
+	MyDB_PageHandle (MyDB_PageHandle &&moveMe) {
+		base.page = moveMe.base.page;
+		moveMe.base.page = nullptr;
+	}
+
+	// assignment covers both copying and moving
+	MyDB_PageHandle &operator = (MyDB_PageHandle fromMe) {
+		swap (base.page, fromMe.base.page);
+		return *this;
+	}
+
 	// There are no more references to the handle when this is called...
 	// this should decrmeent a reference count to the number of handles
 	// to the particular page that it references.  If the number of 
 	// references to a pinned page goes down to zero, then the page should
 	// become unpinned.  
-	~MyDB_PageHandleBase () {
-		page->decRefCount (page);
+	~MyDB_PageHandle () {
+		if (base.page != nullptr)
+			base.page->decRefCount ();
+	}
+
+	const MyDB_PageHandleBase *operator -> () const {
+		return &base;
 	}
 
-	// sets up the page...
-	MyDB_PageHandleBase (MyDB_PagePtr useMe) {
-		page = useMe;
-		page->incRefCount ();
+	bool operator == (nullptr_t) const {
+		return base.page == nullptr;
+	}
+
+	bool operator != (nullptr_t) const {
+		return base.page != nullptr;
 	}
 
 private:
 
-	friend class MyDB_PageReaderWriter;
+	friend class MyDB_BufferManager;
 
-	// get the buffer manager
-	MyDB_BufferManager &getParent () {
-		return page->getParent ();
+	// sets up the handle, adding a reference to the page
+	explicit MyDB_PageHandle (MyDB_Page *useMe) {
+		base.page = useMe;
+		if (useMe != nullptr)
+			useMe->incRefCount ();
 	}
 
-	friend class CheckLRU;
-	friend class MyDB_BufferManager;
-	MyDB_PagePtr page;
+	MyDB_PageHandleBase base;
 };
 
 #endif
-
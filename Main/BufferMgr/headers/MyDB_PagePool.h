@@ -0,0 +1,49 @@
+
+#ifndef PAGE_POOL_H
+#define PAGE_POOL_H
+
+#include <memory>
+#include <mutex>
+#include "MyDB_Page.h"
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// the number of page objects that the pool gets from the heap at a time
+#define PAGE_POOL_CHUNK 64
+
+// the page objects for a buffer manager are carved out of chunks of memory that are
+// kept around for as long as the buffer manager is... when a page object goes away,
+// its memory is put aside for the next page, so that once the pool has grown to the
+// number of pages in use at the same time, making a page object does not touch the heap.
+// Every page made by the pool must be gone before the pool is
+class MyDB_PagePool {
+
+public:
+
+	// makes a page object (the arguments are those of the MyDB_Page constructor)
+	MyDB_PagePtr make (MyDB_TablePtr myTable, size_t fileId, size_t i, size_t numBytes, int order,
+		MyDB_BufferManager &parent);
+
+	// destroys a page object that nobody refers to any more, keeping its memory
+	void recycle (MyDB_Page *recycleMe);
+
+	// the number of page objects that the pool has room for, and how many are in use
+	size_t getCapacity ();
+	size_t getNumInUse ();
+
+private:
+
+	typedef aligned_storage <sizeof (MyDB_Page), alignof (MyDB_Page)> :: type PageMemory;
+
+	// the chunks, and the memory in them that is not being used by a page
+	vector <unique_ptr <PageMemory []>> chunks;
+	vector <PageMemory *> spare;
+
+	// protects everything
+	mutex latch;
+};
+
+#endif
+
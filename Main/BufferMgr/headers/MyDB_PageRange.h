@@ -0,0 +1,106 @@
+
+#ifndef PAGE_RANGE_H
+#define PAGE_RANGE_H
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include "MyDB_PageHandle.h"
+#include <vector>
+
+using namespace std;
+
+class MyDB_PageRange;
+typedef shared_ptr <MyDB_PageRange> MyDB_PageRangePtr;
+
+// a run of consecutive pages of a table that were pinned together (see
+// MyDB_BufferManager :: pinRange).  The pages stay pinned for as long as the range is
+// around (or someone else has a handle to them), and their bytes can be used as if
+// they were one big buffer: the byte at offset k is byte k % (page size) of page
+// k / (page size).  The pages' bytes never move while they are pinned, so they are
+// found once, when the range is made
+class MyDB_PageRange {
+
+public:
+
+	// the number of pages in the range, and the number of bytes in each of them
+	size_t getNumPages () {
+		return pages.size ();
+	}
+
+	size_t getPageSize () {
+		return pageSize;
+	}
+
+	// the number of bytes in the whole range
+	size_t getNumBytes () {
+		return pages.size () * pageSize;
+	}
+
+	// the handle to the i^th page of the range
+	MyDB_PageHandle &getPage (size_t i) {
+		return pages[i];
+	}
+
+	// the bytes of the i^th page of the range
+	char *getPageBytes (size_t i) {
+		return bytes[i];
+	}
+
+	// the byte at the given offset into the range
+	char &operator [] (size_t offset) {
+		return bytes[offset / pageSize][offset % pageSize];
+	}
+
+	// copies numBytes bytes, starting at the given offset into the range, out of the range
+	void copyOut (size_t offset, void *toHere, size_t numBytes) {
+		char *to = (char *) toHere;
+		while (numBytes > 0) {
+			size_t inPage = min (numBytes, pageSize - offset % pageSize);
+			memcpy (to, bytes[offset / pageSize] + offset % pageSize, inPage);
+			to += inPage;
+			offset += inPage;
+			numBytes -= inPage;
+		}
+	}
+
+	// copies numBytes bytes into the range, starting at the given offset; the pages that
+	// are written to are marked as dirty
+	void copyIn (size_t offset, const void *fromHere, size_t numBytes) {
+		const char *from = (const char *) fromHere;
+		while (numBytes > 0) {
+			size_t inPage = min (numBytes, pageSize - offset % pageSize);
+			memcpy (bytes[offset / pageSize] + offset % pageSize, from, inPage);
+			pages[offset / pageSize]->wroteBytes ();
+			from += inPage;
+			offset += inPage;
+			numBytes -= inPage;
+		}
+	}
+
+	// let every page in the range know that its bytes were written
+	void wroteBytes () {
+		for (auto &page : pages)
+			page->wroteBytes ();
+	}
+
+private:
+
+	friend class MyDB_BufferManager;
+
+	// sets up the range from handles to the (pinned) pages, their bytes, and their size
+	MyDB_PageRange (vector <MyDB_PageHandle> &pagesIn, vector <char *> &bytesIn, size_t pageSizeIn) {
+		pages.swap (pagesIn);
+		bytes.swap (bytesIn);
+		pageSize = pageSizeIn;
+	}
+
+	// the pages, and their bytes
+	vector <MyDB_PageHandle> pages;
+	vector <char *> bytes;
+
+	size_t pageSize;
+};
+
+#endif
+
@@ -0,0 +1,75 @@
+
+#ifndef PAGE_TABLE_H
+#define PAGE_TABLE_H
+
+#include <functional>
+#include "MyDB_Page.h"
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// this is an open-addressing (linear probing) hash table that maps a (file id, page number)
+// pair to the page object that the buffer manager has for that page... it replaces a map
+// ordered by table name, so that finding a page costs one hash and (usually) one probe
+class MyDB_PageTable {
+
+public:
+
+	// creates an empty table
+	MyDB_PageTable ();
+
+	// returns the slot for the given page; if the page is not in the table, a slot is
+	// added for it, and the returned pointer is a nullptr that the caller must fill in
+	MyDB_PagePtr &findOrAdd (size_t fileId, size_t pageNo);
+
+	// returns the page, or a nullptr if the page is not in the table
+	MyDB_PagePtr find (size_t fileId, size_t pageNo);
+
+	// removes the page from the table, if it is there; if onlyMe is not a nullptr, the
+	// entry is removed only if it is for that particular page object... returns the
+	// page that was removed (or a nullptr)
+	MyDB_PagePtr erase (size_t fileId, size_t pageNo, MyDB_Page *onlyMe = nullptr);
+
+	// calls the lambda on every page in the table
+	void forEach (function <void (MyDB_PagePtr &)> doMe);
+
+	// the number of pages in the table
+	size_t size ();
+
+	// hashes the key
+	static inline size_t hash (size_t fileId, size_t pageNo) {
+		size_t h = (pageNo * 0x9E3779B97F4A7C15ULL) ^ (fileId * 0xC2B2AE3D27D4EB4FULL);
+		return h ^ (h >> 29);
+	}
+
+private:
+
+	struct Slot {
+		size_t fileId;
+		size_t pageNo;
+		MyDB_PagePtr page;
+	};
+
+	// finds the slot where the key is, or where it would go
+	size_t probe (size_t fileId, size_t pageNo);
+
+	// doubles the number of slots
+	void grow ();
+
+	// the slots; the number of them is always a power of two
+	vector <Slot> slots;
+
+	// the number of slots that are in use
+	size_t numUsed;
+};
+
+// the buffer manager splits its pages over a number of page tables, each with its own
+// latch, so that threads looking up different pages do not fight over one lock
+struct MyDB_PagePartition {
+	mutex latch;
+	MyDB_PageTable pages;
+};
+
+#endif
+
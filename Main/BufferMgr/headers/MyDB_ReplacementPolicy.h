@@ -0,0 +1,107 @@
+
+#ifndef REPLACEMENT_POLICY_H
+#define REPLACEMENT_POLICY_H
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// the replacement policies that a buffer manager can be created with
+enum MyDB_ReplacementType {ClockReplacement, LRUReplacement, LRUKReplacement, TwoQReplacement, ARCReplacement};
+
+class MyDB_ReplacementPolicy;
+typedef shared_ptr <MyDB_ReplacementPolicy> MyDB_ReplacementPolicyPtr;
+
+// a replacement policy decides which of the buffer manager's frames to take away
+// from the page living there when a new page needs a frame.  The policy only
+// knows about frame numbers (and the ids of the pages that come into them); the
+// buffer manager decides whether the page in a frame can actually be kicked out.
+//
+// In addition to whatever the actual policy does, pages that come in as part of a
+// big sequential scan are kept off to the side in a small ring of frames, and as
+// long as the ring is full, those frames are reused first... so a scan of a big
+// table does not push all of the hot pages out of the buffer.  A page in the ring
+// that is come back to (rather than just used over and over by the scan) is handed
+// over to the actual policy when its frame comes up for reuse
+class MyDB_ReplacementPolicy {
+
+public:
+
+	// creates a policy of the given type over numFrames frames (frames 0 through
+	// numFrames - 1), whose ring for scanned pages holds ringFrames frames; the buffer
+	// may later be resized to have as many as maxFrames frames
+	static MyDB_ReplacementPolicyPtr create (MyDB_ReplacementType type, size_t maxFrames, size_t numFrames, size_t ringFrames);
+
+	// the page (fileId, pageNo) was just put into the (previously free) frame;
+	// fromScan is true if it was read as part of a sequential scan
+	void admit (size_t frame, size_t fileId, size_t pageNo, bool fromScan);
+
+	// the page in the frame was just used; this is the only call that is made
+	// without the buffer manager's pool latch held, and it can race with the
+	// frame changing hands
+	void touch (size_t frame);
+
+	// the frame was emptied by the buffer manager (not because it was picked as a victim)
+	void remove (size_t frame);
+
+	// goes through the frames in the order that they should be kicked out, calling
+	// claim on each one until it returns true; that frame is returned (and forgotten
+	// about by the policy), or -1 if claim never returns true
+	long findVictim (function <bool (size_t)> &claim);
+
+	// the buffer now has numFrames frames, all of them below frameLimit (the frames that
+	// were taken away have already been emptied), and the ring holds ringFrames frames
+	void resize (size_t numFrames, size_t frameLimit, size_t ringFrames);
+
+	MyDB_ReplacementPolicy (size_t maxFrames, size_t numFrames, size_t ringFrames);
+	virtual ~MyDB_ReplacementPolicy ();
+
+protected:
+
+	// these are the same as the above, but for the pages that the actual policy handles
+	virtual void admitPage (size_t frame, size_t fileId, size_t pageNo) = 0;
+	virtual void touchPage (size_t frame) = 0;
+	virtual void removePage (size_t frame) = 0;
+	virtual long findPageVictim (function <bool (size_t)> &claim) = 0;
+
+	// called once the buffer has been resized, for the policies whose targets depend
+	// on the number of frames
+	virtual void resized ();
+
+	// packs a page id into one number, for the policies that remember pages that
+	// are no longer buffered
+	static size_t pageKey (size_t fileId, size_t pageNo);
+
+	// the number of frames, and one past the highest frame that can be in use
+	size_t numFrames;
+	size_t frameLimit;
+
+private:
+
+	// tries to claim one of the frames in the ring, oldest first
+	long findRingVictim (function <bool (size_t)> &claim);
+
+	// the frames holding scanned pages, in the order that they were filled
+	deque <size_t> ring;
+
+	// whether each frame is in the ring
+	unique_ptr <atomic <bool> []> inRing;
+
+	// the number of separate uses of the page in each frame in the ring, and the
+	// ring frame that was used last (uses of a page one right after the other count once)
+	unique_ptr <atomic <int> []> ringUses;
+	atomic <long> lastRingTouch;
+
+	// the page in each frame in the ring
+	vector <pair <size_t, size_t>> ringPages;
+
+	// how many frames the ring may hold before its frames are reused
+	size_t ringFrames;
+};
+
+#endif
+
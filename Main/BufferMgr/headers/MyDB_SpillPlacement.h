@@ -0,0 +1,14 @@
+
+#ifndef SPILL_PLACEMENT_H
+#define SPILL_PLACEMENT_H
+
+// this lists the ways that new temp pages can be spread over the spill directories
+// (see MyDB_BufferOptions.h)
+//
+// RoundRobinSpill: each directory gets the next temp page in turn
+// FreeSpaceSpill: a temp page goes where there is already a free spot for it, and
+// otherwise into the directory whose file system has the most free space
+enum MyDB_SpillPlacement {RoundRobinSpill, FreeSpaceSpill};
+
+#endif
+
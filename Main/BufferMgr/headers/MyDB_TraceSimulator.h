@@ -0,0 +1,55 @@
+
+#ifndef TRACE_SIMULATOR_H
+#define TRACE_SIMULATOR_H
+
+#include "MyDB_AccessTrace.h"
+#include "MyDB_ReplacementPolicy.h"
+#include <vector>
+
+using namespace std;
+
+// plays a trace (see MyDB_AccessTrace.h) back against a buffer of some number of
+// frames, counting the misses that there would have been.  The replacement policies
+// are the buffer manager's own, and the buffer does what the buffer manager would:
+// pages are read in when they are read, written, or pinned (write entries follow the
+// read entries for the same bytes, and so they never miss), and pinned pages are
+// never kicked out.  Unlike the buffer manager, every page takes up one frame, there
+// is no reading ahead or ring of frames for scans, and a page that has no frame
+// because every frame is pinned is just counted as a miss and not buffered
+class MyDB_TraceSimulator {
+
+public:
+
+	// sets up the simulator for the entries of a trace, which are taken over
+	MyDB_TraceSimulator (vector <MyDB_TraceEntry> &entries);
+
+	// the number of entries that use a page (that is, all but the un-pins and writes),
+	// and the number of different pages that they use
+	size_t getNumAccesses ();
+	size_t getNumPages ();
+
+	// returns the number of misses with a buffer of numFrames frames run by the policy
+	size_t simulate (MyDB_ReplacementType type, size_t numFrames);
+
+	// the same, but for Belady's algorithm, which kicks out the page that will not be
+	// used for the longest time... without pinning, no policy can do better than this
+	size_t simulateOptimal (size_t numFrames);
+
+private:
+
+	// the trace
+	vector <MyDB_TraceEntry> entries;
+
+	// the pages used by the entries, numbered from 0
+	vector <size_t> pageIds;
+	size_t numPages;
+
+	// the number of entries that use a page
+	size_t numAccesses;
+
+	// true if the entry uses its page
+	static bool isAccess (MyDB_TraceEntry &entry);
+};
+
+#endif
+
@@ -0,0 +1,61 @@
+
+#ifndef TWOQ_POLICY_H
+#define TWOQ_POLICY_H
+
+#include <list>
+#include <mutex>
+#include "MyDB_ReplacementPolicy.h"
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// the (full) 2Q algorithm of Johnson and Shasha: a page that is brought in for the
+// first time goes into a small FIFO queue (A1in).  When it is kicked out of there,
+// its id is remembered in a second FIFO (A1out), and if it is brought back while it
+// is still remembered, it goes into the main LRU list (Am).  So only pages that are
+// used more than once, some time apart, can push pages out of the main list
+class MyDB_TwoQPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	MyDB_TwoQPolicy (size_t maxFrames, size_t numFrames, size_t ringFrames);
+
+protected:
+
+	void admitPage (size_t frame, size_t fileId, size_t pageNo) override;
+	void touchPage (size_t frame) override;
+	void removePage (size_t frame) override;
+	long findPageVictim (function <bool (size_t)> &claim) override;
+	void resized () override;
+
+private:
+
+	// tries to kick out the oldest page from the given list that can be claimed
+	long claimFrom (list <size_t> &fromMe, function <bool (size_t)> &claim);
+
+	// the frames in A1in (newest first), and in Am (most recently used first)
+	list <size_t> in;
+	list <size_t> main;
+
+	// the pages remembered in A1out (newest first)
+	list <size_t> out;
+	unordered_map <size_t, list <size_t> :: iterator> outPages;
+
+	// which list each frame is in (a nullptr if none), and where it is in there
+	vector <list <size_t> *> which;
+	vector <list <size_t> :: iterator> where;
+
+	// the page in each frame
+	vector <size_t> keys;
+
+	// the target size of A1in, and the most pages that A1out remembers
+	size_t kIn;
+	size_t kOut;
+
+	// protects everything
+	mutex latch;
+};
+
+#endif
+
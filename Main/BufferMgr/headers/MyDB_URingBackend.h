@@ -0,0 +1,72 @@
+
+#ifndef URING_BACKEND_H
+#define URING_BACKEND_H
+
+#include <atomic>
+#include <linux/io_uring.h>
+#include "MyDB_PReadBackend.h"
+#include <mutex>
+
+using namespace std;
+
+// the number of rings, so that several threads can have I/O going at once
+#define NUM_RINGS 4
+
+// the most requests that are submitted to a ring at once
+#define RING_ENTRIES 64
+
+// hands batches of runs to the kernel through io_uring: all of the runs in a batch
+// are submitted, and then waited for, with one io_uring_enter.  A thread uses
+// whichever ring it can get; if io_uring cannot be set up, this falls back to
+// preadv and pwritev
+class MyDB_URingBackend : public MyDB_PReadBackend {
+
+public:
+
+	MyDB_URingBackend ();
+	~MyDB_URingBackend ();
+
+	void read (MyDB_IORequest &request) override;
+	void write (vector <MyDB_IORequest> &requests) override;
+	MyDB_IOBackendType getType () override;
+
+private:
+
+	// one io_uring, with the kernel's submission and completion queues mapped in
+	struct Ring {
+
+		int fd;
+
+		// the submission queue, and the entries that it points into
+		unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+		struct io_uring_sqe *sqes;
+
+		// the completion queue
+		unsigned *cqHead, *cqTail, *cqMask;
+		struct io_uring_cqe *cqes;
+
+		// the mappings
+		void *sqMapping, *cqMapping, *sqeMapping;
+		size_t sqMappingSize, cqMappingSize, sqeMappingSize;
+
+		// only one thread uses a ring at a time
+		mutex latch;
+	};
+
+	// sets up the ring, returning false if io_uring is not available
+	bool setUp (Ring &ring);
+
+	// submits the requests (there can be at most RING_ENTRIES of them) as reads or
+	// writes, and waits for them all to finish
+	void submit (Ring &ring, MyDB_IORequest *requests, size_t numRequests, bool isWrite);
+
+	// grabs a ring, preferring one that nobody is using
+	Ring &getRing ();
+
+	vector <unique_ptr <Ring>> rings;
+
+	// where the next thread starts looking for a ring
+	atomic <size_t> nextRing;
+};
+
+#endif
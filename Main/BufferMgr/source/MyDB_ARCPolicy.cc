@@ -0,0 +1,129 @@
+
+#ifndef ARC_POLICY_C
+#define ARC_POLICY_C
+
+#include <algorithm>
+#include "MyDB_ARCPolicy.h"
+
+using namespace std;
+
+MyDB_ARCPolicy :: MyDB_ARCPolicy (size_t maxFrames, size_t numFrames, size_t ringFrames) : 
+	MyDB_ReplacementPolicy (maxFrames, numFrames, ringFrames), which (maxFrames, nullptr), where (maxFrames), keys (maxFrames) {
+	p = 0;
+	lastTouched = -1;
+}
+
+void MyDB_ARCPolicy :: forget (list <size_t> &ghosts) {
+	if (ghosts.size () > 0) {
+		ghostPages.erase (ghosts.back ());
+		ghosts.pop_back ();
+	}
+}
+
+void MyDB_ARCPolicy :: admitPage (size_t frame, size_t fileId, size_t pageNo) {
+	lock_guard <mutex> guard (latch);
+
+	size_t key = pageKey (fileId, pageNo);
+	auto found = ghostPages.find (key);
+
+	// a page remembered in B1 means that T1 should have been bigger
+	if (found != ghostPages.end () && found->second.first == &b1) {
+		double delta = b1.size () >= b2.size () ? 1.0 : (double) b2.size () / b1.size ();
+		p = min ((double) numFrames, p + delta);
+		b1.erase (found->second.second);
+		ghostPages.erase (found);
+		t2.push_front (frame);
+		which[frame] = &t2;
+
+	// and a page remembered in B2 means that T2 should have been bigger
+	} else if (found != ghostPages.end ()) {
+		double delta = b2.size () >= b1.size () ? 1.0 : (double) b1.size () / b2.size ();
+		p = max (0.0, p - delta);
+		b2.erase (found->second.second);
+		ghostPages.erase (found);
+		t2.push_front (frame);
+		which[frame] = &t2;
+
+	// a brand new page; keep T1 + B1 and everything together from getting too big
+	} else {
+		if (t1.size () + b1.size () >= numFrames)
+			forget (b1);
+		else if (t1.size () + t2.size () + b1.size () + b2.size () >= 2 * numFrames)
+			forget (b2);
+		t1.push_front (frame);
+		which[frame] = &t1;
+	}
+
+	where[frame] = which[frame]->begin ();
+	keys[frame] = key;
+	lastTouched = frame;
+}
+
+void MyDB_ARCPolicy :: resized () {
+	lock_guard <mutex> guard (latch);
+
+	// the target for T1 cannot be more than the whole buffer, and there cannot be more
+	// pages remembered than in a full buffer of this size
+	p = min ((double) numFrames, p);
+	while (t1.size () + b1.size () > numFrames && b1.size () > 0)
+		forget (b1);
+	while (t1.size () + t2.size () + b1.size () + b2.size () > 2 * numFrames && b2.size () > 0)
+		forget (b2);
+}
+
+void MyDB_ARCPolicy :: touchPage (size_t frame) {
+	lock_guard <mutex> guard (latch);
+	if (which[frame] == nullptr || lastTouched == (long) frame)
+		return;
+
+	// a second use moves a page over to T2
+	t2.splice (t2.begin (), *which[frame], where[frame]);
+	which[frame] = &t2;
+	lastTouched = frame;
+}
+
+void MyDB_ARCPolicy :: removePage (size_t frame) {
+	lock_guard <mutex> guard (latch);
+	if (which[frame] != nullptr) {
+		which[frame]->erase (where[frame]);
+		which[frame] = nullptr;
+	}
+}
+
+long MyDB_ARCPolicy :: claimFrom (list <size_t> &fromMe, list <size_t> &ghosts, function <bool (size_t)> &claim) {
+	for (auto it = fromMe.rbegin (); it != fromMe.rend (); it++) {
+		size_t frame = *it;
+		if (!claim (frame))
+			continue;
+
+		fromMe.erase (where[frame]);
+		which[frame] = nullptr;
+		ghosts.push_front (keys[frame]);
+		ghostPages[keys[frame]] = make_pair (&ghosts, ghosts.begin ());
+		if (ghosts.size () > numFrames)
+			forget (ghosts);
+		return frame;
+	}
+	return -1;
+}
+
+long MyDB_ARCPolicy :: findPageVictim (function <bool (size_t)> &claim) {
+	lock_guard <mutex> guard (latch);
+
+	// take from T1 if it is bigger than its target, and from T2 otherwise... if
+	// everything in that list is busy, try the other one
+	long victim;
+	if (t1.size () > 0 && t1.size () > p) {
+		victim = claimFrom (t1, b1, claim);
+		if (victim == -1)
+			victim = claimFrom (t2, b2, claim);
+	} else {
+		victim = claimFrom (t2, b2, claim);
+		if (victim == -1)
+			victim = claimFrom (t1, b1, claim);
+	}
+	return victim;
+}
+
+#endif
+
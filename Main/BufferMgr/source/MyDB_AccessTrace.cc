@@ -0,0 +1,97 @@
+
+#ifndef ACCESS_TRACE_C
+#define ACCESS_TRACE_C
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include "MyDB_AccessTrace.h"
+#include <unistd.h>
+
+using namespace std;
+
+// the first bytes of every trace file
+static const char traceMagic[8] = {'M', 'Y', 'D', 'B', 'T', 'R', 'C', '1'};
+
+// writes all of the bytes, no matter how many calls that takes; false on an error
+static bool writeAll (int fd, const void *bytes, size_t numBytes) {
+	const char *from = (const char *) bytes;
+	while (numBytes > 0) {
+		ssize_t written = write (fd, from, numBytes);
+		if (written <= 0)
+			return false;
+		from += written;
+		numBytes -= written;
+	}
+	return true;
+}
+
+MyDB_AccessTrace :: MyDB_AccessTrace (string fileName, size_t pageSize) {
+	fd = open (fileName.c_str (), O_CREAT | O_TRUNC | O_WRONLY, 0666);
+	uint64_t size = pageSize;
+	if (fd == -1 || !writeAll (fd, traceMagic, sizeof (traceMagic)) || !writeAll (fd, &size, sizeof (size))) {
+		cout << "Can't start the trace " << fileName << "!!\n";
+		exit (1);
+	}
+	start = chrono :: steady_clock :: now ();
+	waiting.reserve (TRACE_BUFFER_ENTRIES);
+}
+
+MyDB_AccessTrace :: ~MyDB_AccessTrace () {
+	lock_guard <mutex> guard (latch);
+	writeEntries ();
+	close (fd);
+}
+
+void MyDB_AccessTrace :: record (size_t fileId, size_t pageNo, MyDB_TraceKind kind) {
+	MyDB_TraceEntry entry;
+	entry.time = chrono :: duration_cast <chrono :: nanoseconds> (chrono :: steady_clock :: now () - start).count ();
+	entry.pageNo = pageNo;
+	entry.fileId = fileId;
+	entry.kind = kind;
+	entry.unused = 0;
+
+	lock_guard <mutex> guard (latch);
+	waiting.push_back (entry);
+	if (waiting.size () == TRACE_BUFFER_ENTRIES)
+		writeEntries ();
+}
+
+void MyDB_AccessTrace :: writeEntries () {
+	if (!writeAll (fd, waiting.data (), waiting.size () * sizeof (MyDB_TraceEntry))) {
+		cout << "Can't write the trace!!\n";
+		exit (1);
+	}
+	waiting.clear ();
+}
+
+bool MyDB_AccessTrace :: read (string fileName, size_t &pageSize, vector <MyDB_TraceEntry> &entries) {
+
+	FILE *file = fopen (fileName.c_str (), "rb");
+	if (file == nullptr)
+		return false;
+
+	// check that it is a trace
+	char magic[sizeof (traceMagic)];
+	uint64_t size;
+	if (fread (magic, sizeof (magic), 1, file) != 1 || memcmp (magic, traceMagic, sizeof (magic)) != 0 ||
+		fread (&size, sizeof (size), 1, file) != 1) {
+		fclose (file);
+		return false;
+	}
+	pageSize = size;
+
+	// and read the entries, a chunk at a time
+	entries.clear ();
+	vector <MyDB_TraceEntry> chunk (TRACE_BUFFER_ENTRIES);
+	size_t numRead;
+	while ((numRead = fread (chunk.data (), sizeof (MyDB_TraceEntry), chunk.size (), file)) > 0)
+		entries.insert (entries.end (), chunk.begin (), chunk.begin () + numRead);
+	fclose (file);
+	return true;
+}
+
+#endif
+
@@ -0,0 +1,82 @@
+
+#ifndef BUDDY_ALLOCATOR_C
+#define BUDDY_ALLOCATOR_C
+
+#include "MyDB_BuddyAllocator.h"
+
+using namespace std;
+
+MyDB_BuddyAllocator :: MyDB_BuddyAllocator (size_t maxFrames) : freeOrder (maxFrames, -1) {
+	int maxOrder = 0;
+	while (((size_t) 2 << maxOrder) <= maxFrames)
+		maxOrder++;
+	freeBlocks.resize (maxOrder + 1);
+	numFree = 0;
+}
+
+long MyDB_BuddyAllocator :: allocate (int order) {
+
+	// find the smallest free block that is big enough
+	int from = order;
+	while (from < (int) freeBlocks.size () && freeBlocks[from].size () == 0)
+		from++;
+	if (from >= (int) freeBlocks.size ())
+		return -1;
+
+	size_t block = *freeBlocks[from].begin ();
+	freeBlocks[from].erase (freeBlocks[from].begin ());
+	freeOrder[block] = -1;
+
+	// and split it until it is the right size, keeping the first half each time
+	while (from > order) {
+		from--;
+		size_t buddy = block + ((size_t) 1 << from);
+		freeBlocks[from].insert (buddy);
+		freeOrder[buddy] = from;
+	}
+
+	numFree -= (size_t) 1 << order;
+	return block;
+}
+
+void MyDB_BuddyAllocator :: free (size_t frame, int order) {
+
+	numFree += (size_t) 1 << order;
+
+	// join the block with its buddy for as long as the buddy is free
+	while (order + 1 < (int) freeBlocks.size ()) {
+		size_t buddy = frame ^ ((size_t) 1 << order);
+		if (buddy >= freeOrder.size () || freeOrder[buddy] != order)
+			break;
+		freeBlocks[order].erase (buddy);
+		freeOrder[buddy] = -1;
+		if (buddy < frame)
+			frame = buddy;
+		order++;
+	}
+
+	freeBlocks[order].insert (frame);
+	freeOrder[frame] = order;
+}
+
+int MyDB_BuddyAllocator :: getFreeOrder (size_t frame) {
+	return freeOrder[frame];
+}
+
+size_t MyDB_BuddyAllocator :: getNumFree () {
+	return numFree;
+}
+
+int MyDB_BuddyAllocator :: getMaxOrder () {
+	return (int) freeBlocks.size () - 1;
+}
+
+int MyDB_BuddyAllocator :: getOrder (size_t numFrames) {
+	int order = 0;
+	while (((size_t) 1 << order) < numFrames)
+		order++;
+	return order;
+}
+
+#endif
+
@@ -13,10 +13,16 @@
 #ifndef BUFFER_MGR_C
 #define BUFFER_MGR_C
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <fcntl.h>
+#include <fstream>
 #include <iostream>
 #include "MyDB_BufferManager.h"
 #include "MyDB_Page.h"
+#include <sys/stat.h>
+#include <sys/statvfs.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
@@ -28,299 +34,1853 @@ size_t MyDB_BufferManager :: getPageSize () {
 	return pageSize;
 }
 
-MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TablePtr whichTable, long i) {
-		
-	// open the file, if it is not open
-	if (fds.count (whichTable) == 0) {
-		int fd = open (whichTable->getStorageLoc ().c_str (), O_CREAT | O_RDWR, 0666);
-		fds[whichTable] = fd;
+size_t MyDB_BufferManager :: getPageSize (MyDB_TablePtr whichTable) {
+	return whichTable->getPageSize () == 0 ? pageSize : whichTable->getPageSize ();
+}
+
+int MyDB_BufferManager :: getOrder (size_t size) {
+	if (size < pageSize || size % pageSize != 0)
+		return -1;
+	int order = MyDB_BuddyAllocator :: getOrder (size / pageSize);
+	if (pageSize << order != size || order > freeFrames->getMaxOrder ())
+		return -1;
+	return order;
+}
+
+void MyDB_BufferManager :: setPinTimeout (long timeoutInMs) {
+	pinTimeout = timeoutInMs;
+}
+
+size_t MyDB_BufferManager :: getNumReads () {
+	return numReads;
+}
+
+MyDB_FrameArena &MyDB_BufferManager :: getArena () {
+	return *arena;
+}
+
+MyDB_IOBackend &MyDB_BufferManager :: getIOBackend () {
+	return *ioBackend;
+}
+
+// turns a live histogram into a snapshot
+static MyDB_LatencyHistogram getHistogram (MyDB_LatencyCounters &counters) {
+	MyDB_LatencyHistogram histogram;
+	for (auto &bucket : counters.buckets)
+		histogram.buckets.push_back (bucket);
+	histogram.count = counters.count;
+	histogram.totalMicros = counters.totalMicros;
+	return histogram;
+}
+
+MyDB_BufferStats MyDB_BufferManager :: getStats () {
+
+	MyDB_BufferStats stats;
+	stats.pageSize = pageSize;
+	stats.numPages = getNumPages ();
+	stats.hits = 0;
+	stats.misses = 0;
+	{
+		lock_guard <mutex> guard (filesLatch);
+		stats.openFiles = openFiles.size ();
+		stats.fileOpens = fileOpens;
+		for (size_t fileId = 0; fileId < files.size (); fileId++) {
+			MyDB_File &file = files[fileId];
+
+			// the other temp files are told apart by where they are
+			MyDB_TableStats table;
+			if (file.table != nullptr)
+				table.table = file.table->getName ();
+			else if (fileId == 0)
+				table.table = "temp";
+			else
+				table.table = file.fileName;
+			table.hits = file.counters->hits.get ();
+			table.misses = file.counters->misses.get ();
+			stats.hits += table.hits;
+			stats.misses += table.misses;
+			stats.tables.push_back (table);
+		}
+	}
+
+	stats.pagesRead = numReads;
+	stats.bytesRead = bytesRead;
+	stats.evictions = evictions;
+	stats.dirtyWriteBacks = dirtyWriteBacks;
+	stats.bytesWritten = bytesWritten;
+	stats.pinFailures = pinFailures;
+	stats.tempPages = 0;
+	{
+		lock_guard <mutex> guard (tempLatch);
+		for (size_t order = 0; order < tempFiles.size (); order++) {
+			for (auto &temp : tempFiles[order])
+				stats.tempPages += temp.lastPos << order;
+		}
+	}
+
+	stats.hasLatencies = trackLatency;
+	stats.readLatency = getHistogram (readLatency);
+	stats.writeLatency = getHistogram (writeLatency);
+	return stats;
+}
+
+bool MyDB_BufferManager :: usesDirectIO (MyDB_TablePtr whichTable) {
+	MyDB_BufferManager *pool = getPoolFor (whichTable);
+	if (pool != this)
+		return pool->usesDirectIO (whichTable);
+
+	size_t fileId = getFileId (whichTable);
+	useFd (fileId);
+	doneWithFd (fileId);
+	lock_guard <mutex> guard (filesLatch);
+	return files[fileId].direct;
+}
+
+bool MyDB_BufferManager :: addPool (string name, MyDB_BufferManagerPtr pool) {
+	if (name == "" || pool == nullptr || pool.get () == this || pool->pageSize != pageSize || pools.count (name) > 0)
+		return false;
+
+	// the pools are read without a latch, so they can't change once pages have been handed out
+	if (inUse || pool->inUse)
+		return false;
+	if (name == SPILL_POOL) {
+		for (auto &other : pools) {
+			if (other.second->inUse)
+				return false;
+		}
+	}
+	pools[name] = pool;
+
+	// anonymous pages from any of the pools go to the spill pool
+	if (name == SPILL_POOL) {
+		spillPool = pool.get ();
+		for (auto &other : pools)
+			other.second->spillPool = spillPool;
+	} else {
+		pool->spillPool = spillPool;
+	}
+	return true;
+}
+
+MyDB_BufferManagerPtr MyDB_BufferManager :: getPool (string name) {
+	auto found = pools.find (name);
+	return found == pools.end () ? nullptr : found->second;
+}
+
+MyDB_BufferManager *MyDB_BufferManager :: getPoolFor (const MyDB_TablePtr &forMe) {
+
+	// every request for a table's pages comes through here, so this is when the pools are fixed
+	if (!inUse.load (memory_order_relaxed))
+		inUse = true;
+
+	// most tables use this pool, so don't look them up if we don't have to
+	if (pools.empty () || forMe == nullptr || forMe->getBufferPool () == "")
+		return this;
+
+	auto found = pools.find (forMe->getBufferPool ());
+	return found == pools.end () ? this : found->second.get ();
+}
+
+size_t MyDB_BufferManager :: getFileId (const MyDB_TablePtr &forMe) {
+
+	// see if we have seen this table object before
+	MyDB_FilePartition &partition = fileIds[(MyDB_PageTable :: hash ((size_t) forMe.get (), 0) >> 32) % NUM_PARTITIONS];
+	{
+		lock_guard <mutex> guard (partition.latch);
+		auto found = partition.fileIds.find (forMe);
+		if (found != partition.fileIds.end ())
+			return found->second;
+	}
+
+	// see if we have seen another table object with the same name
+	size_t fileId;
+	{
+		lock_guard <mutex> guard (filesLatch);
+		auto foundName = fileIdsByName.find (forMe->getName ());
+		if (foundName != fileIdsByName.end ()) {
+			fileId = foundName->second;
+
+		// if not, this is a brand new file
+		} else {
+			if (getOrder (getPageSize (forMe)) == -1) {
+				cout << "Can't use pages of " << getPageSize (forMe) << " bytes for table " << forMe->getName () << 
+					"; they must be " << pageSize << " bytes times a power of two, and fit in the buffer!!\n";
+				exit (1);
+			}
+			fileId = files.size ();
+			files.push_back (MyDB_File (forMe, forMe->getStorageLoc (), getPageSize (forMe)));
+			fileIdsByName[forMe->getName ()] = fileId;
+		}
+
+		// all of the table objects for a file must agree on its page size
+		if (files[fileId].pageSize != getPageSize (forMe)) {
+			cout << "Can't use pages of " << getPageSize (forMe) << " bytes for table " << forMe->getName () << 
+				"; its file has pages of " << files[fileId].pageSize << " bytes!!\n";
+			exit (1);
+		}
+	}
+
+	lock_guard <mutex> guard (partition.latch);
+	partition.fileIds[forMe] = fileId;
+	return fileId;
+}
+
+int MyDB_BufferManager :: useFd (size_t fileId) {
+
+	lock_guard <mutex> guard (filesLatch);
+	MyDB_File &file = files[fileId];
+	file.fdUsers++;
+
+	// if the file is open, it just moves to the front of the list
+	if (file.fd != -1) {
+		openFiles.splice (openFiles.begin (), openFiles, file.openPos);
+		return file.fd;
+	}
+
+	// otherwise, make room for it by closing the files that were used least recently
+	// (but not the ones that are being used right now)... their dirty pages stay in the
+	// buffer, and the files are opened again when the pages are written back
+	for (auto it = openFiles.end (); openFiles.size () >= maxOpenFiles && it != openFiles.begin ();) {
+		it--;
+		MyDB_File &closeMe = files[*it];
+		if (closeMe.fdUsers > 0)
+			continue;
+		ioBackend->closingFile (closeMe.fd);
+		close (closeMe.fd);
+		closeMe.fd = -1;
+		it = openFiles.erase (it);
+	}
+
+	// and open it... a temp file is wiped the first time it is opened
+	{
+		int flags = O_CREAT | O_RDWR;
+		if (file.table == nullptr && !file.opened)
+			flags |= O_TRUNC;
+
+		// some file systems (older tmpfs, for one) refuse O_DIRECT; those files are
+		// read and written through the kernel's page cache after all
+		if (directIO) {
+			file.fd = open (file.fileName.c_str (), flags | O_DIRECT, 0666);
+			file.direct = file.fd != -1;
+		}
+		if (file.fd == -1)
+			file.fd = open (file.fileName.c_str (), flags, 0666);
+		if (file.fd == -1) {
+			cout << "Can't open " << file.fileName << "!!\n";
+			exit (1);
+		}
+		ioBackend->openedFile (file.fd);
+		file.opened = true;
+		file.openPos = openFiles.insert (openFiles.begin (), fileId);
+		fileOpens++;
+		adviseKernel (file);
+	}
+	return file.fd;
+}
+
+void MyDB_BufferManager :: doneWithFd (size_t fileId) {
+	lock_guard <mutex> guard (filesLatch);
+	files[fileId].fdUsers--;
+}
+
+void MyDB_BufferManager :: adviseKernel (MyDB_File &file) {
+
+	// temp pages are read back one at a time, in no particular order
+	int advice = POSIX_FADV_NORMAL;
+	if (file.table == nullptr || file.advice == RandomAccess)
+		advice = POSIX_FADV_RANDOM;
+	else if (file.advice == SequentialAccess)
+		advice = POSIX_FADV_SEQUENTIAL;
+	posix_fadvise (file.fd, 0, 0, advice);
+}
+
+MyDB_FileCounters *MyDB_BufferManager :: getCounters (size_t fileId) {
+	lock_guard <mutex> guard (filesLatch);
+	return files[fileId].counters.get ();
+}
+
+void MyDB_BufferManager :: addLatency (MyDB_LatencyCounters &addTo, chrono :: steady_clock :: time_point start) {
+	if (trackLatency)
+		addTo.add (chrono :: duration_cast <chrono :: microseconds> (chrono :: steady_clock :: now () - start).count ());
+}
+
+// this is only used to read a page that someone asked for, so it is a miss
+void MyDB_BufferManager :: readPage (MyDB_Page *readMe) {
+	if (readMe->counters == nullptr)
+		readMe->counters = getCounters (readMe->fileId);
+	readMe->counters->misses.add (1);
+	numReads++;
+	bytesRead += readMe->numBytes;
+
+	struct iovec buffer = {readMe->bytes, readMe->numBytes};
+	MyDB_IORequest request = {useFd (readMe->fileId), &buffer, 1, (off_t) (readMe->pos * readMe->numBytes)};
+	chrono :: steady_clock :: time_point start;
+	if (trackLatency)
+		start = chrono :: steady_clock :: now ();
+	ioBackend->read (request);
+	addLatency (readLatency, start);
+	doneWithFd (readMe->fileId);
+}
+
+void MyDB_BufferManager :: writePage (MyDB_Page *writeMe) {
+	dirtyWriteBacks++;
+	writeMe->onDisk = true;
+	bytesWritten += writeMe->numBytes;
+	struct iovec buffer = {writeMe->bytes, writeMe->numBytes};
+	vector <MyDB_IORequest> requests {{useFd (writeMe->fileId), &buffer, 1, (off_t) (writeMe->pos * writeMe->numBytes)}};
+	chrono :: steady_clock :: time_point start;
+	if (trackLatency)
+		start = chrono :: steady_clock :: now ();
+	ioBackend->write (requests);
+	addLatency (writeLatency, start);
+	doneWithFd (writeMe->fileId);
+}
+
+void MyDB_BufferManager :: writePages (vector <MyDB_Page *> &writeMe) {
+
+	// the buffers line up with the pages, so each run's buffers are all together
+	vector <struct iovec> buffers (writeMe.size ());
+	vector <MyDB_IORequest> requests;
+	vector <size_t> fileIds;
+	size_t numBytes = 0;
+	for (size_t first = 0; first < writeMe.size ();) {
+
+		// find the end of this run of consecutive pages
+		size_t last = first;
+		while (last + 1 < writeMe.size () && last + 1 - first < MAX_WRITE_RUN && 
+			writeMe[last + 1]->fileId == writeMe[first]->fileId && writeMe[last + 1]->pos == writeMe[last]->pos + 1)
+			last++;
+
+		// (all of the pages in a file are the same size)
+		for (size_t i = first; i <= last; i++) {
+			buffers[i].iov_base = writeMe[i]->bytes;
+			buffers[i].iov_len = writeMe[i]->numBytes;
+			numBytes += writeMe[i]->numBytes;
+			writeMe[i]->onDisk = true;
+		}
+		requests.push_back (MyDB_IORequest {useFd (writeMe[first]->fileId), &buffers[first], 
+			(int) (last - first + 1), (off_t) (writeMe[first]->pos * writeMe[first]->numBytes)});
+		fileIds.push_back (writeMe[first]->fileId);
+		first = last + 1;
 	}
 
+	// and write them all
+	if (requests.size () > 0) {
+		dirtyWriteBacks += writeMe.size ();
+		bytesWritten += numBytes;
+		chrono :: steady_clock :: time_point start;
+		if (trackLatency)
+			start = chrono :: steady_clock :: now ();
+		ioBackend->write (requests);
+		addLatency (writeLatency, start);
+	}
+	for (size_t fileId : fileIds)
+		doneWithFd (fileId);
+}
+
+bool MyDB_BufferManager :: inFileOrder (MyDB_Page *lhs, MyDB_Page *rhs) {
+	if (lhs->fileId != rhs->fileId)
+		return lhs->fileId < rhs->fileId;
+	return lhs->pos < rhs->pos;
+}
+
+void MyDB_BufferManager :: flush () {
+
+	// the other pools first
+	for (auto &pool : pools)
+		pool.second->flush ();
+
+	// find all of the dirty pages; holding on to them keeps them from going away
+	vector <MyDB_PagePtr> dirty;
+	for (auto &partition : allPages) {
+		lock_guard <mutex> guard (partition.latch);
+		partition.pages.forEach ([&dirty] (MyDB_PagePtr &page) {
+			if (page->frame != -1 && page->isDirty)
+				dirty.push_back (page);
+		});
+	}
+	sort (dirty.begin (), dirty.end (), [] (const MyDB_PagePtr &lhs, const MyDB_PagePtr &rhs) {
+		return inFileOrder (lhs.get (), rhs.get ());
+	});
+
+	// latch them a run at a time, in file order (everyone else who latches more than one
+	// page at a time only ever tries to latch), and write out the ones still dirty...
+	// they are marked clean before they are written, so a change made while they are
+	// being written marks them dirty again
+	vector <MyDB_Page *> run;
+	for (size_t i = 0; i < dirty.size (); i++) {
+		MyDB_Page *page = dirty[i].get ();
+		page->latch.lock ();
+		if (page->frame != -1 && page->isDirty) {
+			page->isDirty = false;
+			run.push_back (page);
+		} else {
+			page->latch.unlock ();
+		}
+
+		if (run.size () == MAX_WRITE_RUN || i + 1 == dirty.size ()) {
+			writePages (run);
+			for (auto written : run)
+				written->latch.unlock ();
+			run.clear ();
+		}
+	}
+}
+
+MyDB_PagePartition &MyDB_BufferManager :: getPartition (size_t fileId, size_t pageNo) {
+	return allPages[(MyDB_PageTable :: hash (fileId, pageNo) >> 32) % NUM_PARTITIONS];
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TablePtr whichTable, long i) {
+		
 	// make sure we don't have a null table
 	if (whichTable == nullptr) {
 		cout << "Can't allocate a page with a null table!!\n";
 		exit (1);
 	}
-	
-	// next, see if the page is already in existence
-	pair <MyDB_TablePtr, long> whichPage = make_pair (whichTable, i);
-	if (allPages.count (whichPage) == 0) {
 
-		// it is not there, so create a page
-		MyDB_PagePtr returnVal = make_shared <MyDB_Page> (whichTable, i, *this);
-		allPages [whichPage] = returnVal;
-		return make_shared <MyDB_PageHandleBase> (returnVal);
+	// the page may belong to another pool
+	MyDB_BufferManager *pool = getPoolFor (whichTable);
+	if (pool != this)
+		return pool->getPage (whichTable, i);
+	
+	// next, see if the page is already in existence; if it is not there, create it
+	size_t fileId = getFileId (whichTable);
+	MyDB_PagePartition &partition = getPartition (fileId, i);
+	lock_guard <mutex> guard (partition.latch);
+	MyDB_PagePtr &returnVal = partition.pages.findOrAdd (fileId, i);
+	if (returnVal == nullptr) {
+		size_t size = getPageSize (whichTable);
+		returnVal = pagePool.make (whichTable, fileId, i, size, getOrder (size), *this);
 	}
 
-	// it is there, so return it
-	return make_shared <MyDB_PageHandleBase> (allPages [whichPage]);
+	// the handle adds a reference to the page while we still hold the partition latch,
+	// so the page cannot be removed from the page table out from under us
+	return MyDB_PageHandle (returnVal.get ());
 }
 
 MyDB_PageHandle MyDB_BufferManager :: getPage () {
+	return getPage (pageSize);
+}
 
-	// open the file, if it is not open
-	if (fds.count (nullptr) == 0) {
-		int fd = open (tempFile.c_str (), O_TRUNC | O_CREAT | O_RDWR, 0666);
-		fds[nullptr] = fd;
+MyDB_PageHandle MyDB_BufferManager :: getPage (size_t size) {
+	return spillPool->getTempPage (size);
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getTempPage (size_t size) {
+
+	if (!inUse.load (memory_order_relaxed))
+		inUse = true;
+
+	int order = getOrder (size);
+	if (order == -1) {
+		cout << "Can't allocate an anonymous page of " << size << " bytes; it must be " << pageSize << 
+			" bytes times a power of two, and fit in the buffer!!\n";
+		exit (1);
 	}
 
-	// check if we are extending the size of the temp file
+	size_t fileId;
 	size_t pos;
-	if (availablePositions.size () == 0) {
-		pos = lastTempPos++;
+	MyDB_FileCounters *counters;
+	{
+		lock_guard <mutex> guard (tempLatch);
+		size_t dir = pickSpillDir (order);
+		MyDB_TempFile &temp = tempFiles[order][dir];
+
+		// the first page of this size in this directory gets a temp file of its own
+		if (temp.fileId == -1) {
+			lock_guard <mutex> filesGuard (filesLatch);
+			temp.fileId = files.size ();
+			string fileName = spillFiles[dir];
+			if (order > 0)
+				fileName += "." + to_string (size);
+			files.push_back (MyDB_File (nullptr, fileName, size));
+			temp.counters = files[temp.fileId].counters.get ();
+		}
+
+		// check if we are extending the size of the temp file
+		if (temp.availablePositions.size () == 0) {
+			pos = temp.lastPos++;
+		} else {
+			pos = *temp.availablePositions.begin ();
+			temp.availablePositions.erase (temp.availablePositions.begin ());
+		}
+		fileId = temp.fileId;
+		counters = temp.counters;
+	}
+
+	MyDB_PagePtr returnVal = pagePool.make (nullptr, fileId, pos, size, order, *this);
+	returnVal->counters = counters;
+	return MyDB_PageHandle (returnVal.get ());
+}
+
+size_t MyDB_BufferManager :: pickSpillDir (int order) {
+
+	if (spillFiles.size () == 1)
+		return 0;
+	if (spillPlacement == RoundRobinSpill)
+		return nextSpill++ % spillFiles.size ();
+
+	// a free spot in a file that is already there does not take up any more space
+	for (size_t dir = 0; dir < spillFiles.size (); dir++) {
+		if (tempFiles[order][dir].availablePositions.size () > 0)
+			return dir;
+	}
+
+	// otherwise, go where there is the most free space... a directory that we can not
+	// look at is taken to be full
+	if (spillChecks++ % SPILL_CHECK_INTERVAL == 0) {
+		for (size_t dir = 0; dir < spillDirs.size (); dir++) {
+			struct statvfs info;
+			spillSpace[dir] = statvfs (spillDirs[dir].c_str (), &info) == 0 ? info.f_bavail * info.f_frsize : 0;
+		}
+	}
+	size_t best = 0;
+	for (size_t dir = 1; dir < spillSpace.size (); dir++) {
+		if (spillSpace[dir] > spillSpace[best])
+			best = dir;
+	}
+	spillSpace[best] -= min (spillSpace[best], pageSize << order);
+	return best;
+}
+
+void MyDB_BufferManager :: freeTempPos (MyDB_Page *freeMe) {
+
+	// punch the page's bytes out of the file before anyone else can have his spot; this
+	// is only a hint, so if the file system can not do it, the space is just not given back
+	size_t numBytes = freeMe->numBytes;
+	bool opened;
+	{
+		lock_guard <mutex> guard (filesLatch);
+		opened = files[freeMe->fileId].opened;
+	}
+	int fd = opened ? useFd (freeMe->fileId) : -1;
+	if (freeMe->onDisk && fd != -1)
+		fallocate (fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, freeMe->pos * numBytes, numBytes);
+
+	{
+		lock_guard <mutex> guard (tempLatch);
+		for (auto &temp : tempFiles[freeMe->order]) {
+			if (temp.fileId != (long) freeMe->fileId)
+				continue;
+
+			// and if the end of the file is all free, give it back
+			temp.availablePositions.insert (freeMe->pos);
+			size_t lastPos = temp.lastPos;
+			while (temp.lastPos > 0 && temp.availablePositions.count (temp.lastPos - 1) > 0) {
+				temp.availablePositions.erase (temp.lastPos - 1);
+				temp.lastPos--;
+			}
+			// (the pages at the end may never have been written, so the file is only ever
+			// cut short here, not made longer)
+			struct stat fileInfo;
+			if (temp.lastPos < lastPos && fd != -1 && fstat (fd, &fileInfo) == 0 && 
+				(size_t) fileInfo.st_size > temp.lastPos * numBytes) {
+				ftruncate (fd, temp.lastPos * numBytes);
+				ioBackend->truncatedFile (fd, temp.lastPos * numBytes);
+			}
+			break;
+		}
+	}
+	if (fd != -1)
+		doneWithFd (freeMe->fileId);
+}
+
+bool MyDB_BufferManager :: claimPage (size_t whichFrame, bool unreferencedOnly) {
+
+	// skip pinned pages (and anonymous pages, which always have a reference, if we
+	// are only after unreferenced pages)
+	MyDB_Page *page = frames[whichFrame].page;
+	if (page == nullptr || page->pinned || (unreferencedOnly && page->myTable == nullptr))
+		return false;
+
+	// skip him if someone else is working with him (for example, he is still being read in)
+	if (!page->latch.try_lock ())
+		return false;
+
+	// now that we have him latched, make sure that he was not pinned in the meantime
+	if (page->pinned || page->frame == -1) {
+		page->latch.unlock ();
+		return false;
+	}
+
+	// a handle is only ever added to a page with its partition latched, so if he has
+	// no references once we hold that latch, nobody can get his bytes without first
+	// seeing that he no longer has a frame
+	if (unreferencedOnly) {
+		MyDB_PagePartition &partition = getPartition (page->fileId, page->pos);
+		lock_guard <mutex> guard (partition.latch);
+		if (page->refCount != 0) {
+			page->latch.unlock ();
+			return false;
+		}
+		page->frame = -1;
 	} else {
-		pos = availablePositions.top ();
-		availablePositions.pop ();
+		page->frame = -1;
 	}
 
-	MyDB_PagePtr returnVal = make_shared <MyDB_Page> (nullptr, pos, *this);
-	return make_shared <MyDB_PageHandleBase> (returnVal);
+	return true;
 }
 
-void MyDB_BufferManager :: kickOutPage () {
-	
-	// find the oldest page
-	auto it = lastUsed.begin();
-	auto page = *it;
+long MyDB_BufferManager :: findVictim (bool unreferencedOnly) {
+	function <bool (size_t)> claim = [this, unreferencedOnly] (size_t whichFrame) {
+		return claimPage (whichFrame, unreferencedOnly);
+	};
+	return policy->findVictim (claim);
+}
 
-	if (lastUsed.size () == 0)
-		cout << "Bad: all buffer memory is exhausted!";
+void MyDB_BufferManager :: claimBlock (size_t whichFrame, int order, long picked, bool unreferencedOnly, vector <long> &victimFrames) {
 
-	// make sure we don't have a null pointer
-	if (page->bytes == nullptr) {
-		cout << "Bad!! Kicking out a page with no RAM.";
-		exit (1);
+	// blocks never straddle a multiple of their size, so the block that we are after is
+	// made up of whole free blocks and the whole blocks of buffered pages... if any of
+	// those pages is pinned, or is on its way in or out, there is no point in going on
+	size_t first = whichFrame & ~(((size_t) 1 << order) - 1);
+	size_t end = first + ((size_t) 1 << order);
+	if (end > frames.size ())
+		return;
+	for (size_t i = first; i < end;) {
+		if (freeFrames->getFreeOrder (i) != -1) {
+			i += (size_t) 1 << freeFrames->getFreeOrder (i);
+			continue;
+		}
+		MyDB_Page *page = frames[i].page;
+		if (page == nullptr || ((long) i != picked && (page->pinned || page->frame == -1)))
+			return;
+		i += (size_t) 1 << page->order;
 	}
 
-	// write it back if necessary
-	if (page->isDirty) {
-		lseek (fds[page->myTable], page->pos * pageSize, SEEK_SET);
-		write (fds[page->myTable], page->bytes, pageSize);
-		page->isDirty = false;
+	// and claim the pages, taking them away from the policy
+	for (size_t i = first; i < end && victimFrames.size () < MAX_WRITE_RUN;) {
+		if (freeFrames->getFreeOrder (i) != -1) {
+			i += (size_t) 1 << freeFrames->getFreeOrder (i);
+			continue;
+		}
+		size_t next = i + ((size_t) 1 << frames[i].page->order);
+		if ((long) i != picked) {
+			if (!claimPage (i, unreferencedOnly))
+				return;
+			policy->remove (i);
+			victimFrames.push_back (i);
+		}
+		i = next;
 	}
+}
 
-	// remove it
-	lastUsed.erase (page);
+void MyDB_BufferManager :: kickOutPage (MyDB_Page *kickMe) {
 
-	// remember its RAM
-	availableRam.push_back (page->bytes);
-	page->bytes = nullptr;
+	evictions++;
 
-	// if this guy has no references, kill him
-	if (page->refCount == 0)
-		killPage (page);
+	// write it back if necessary
+	if (kickMe->isDirty) {
+		writePage (kickMe);
+		kickMe->isDirty = false;
+	}
+	kickMe->bytes = nullptr;
+
+	// if this guy has no references, kill him... the page object is destroyed (if
+	// at all) only after we have let go of his latch
+	MyDB_PagePtr killed;
+	if (kickMe->myTable != nullptr && kickMe->refCount == 0)
+		killed = erasePage (kickMe);
+
+	kickMe->latch.unlock ();
 }
 
-void MyDB_BufferManager :: killPage (MyDB_PagePtr killMe) {
-	
+long MyDB_BufferManager :: getFrame (MyDB_Page *forMe, bool background, bool fromScan, bool granted) {
+
+	unique_lock <mutex> pool (poolLatch);
+	long timeout = granted ? max (pinTimeout, (long) GRANT_PIN_TIMEOUT) : pinTimeout;
+	auto deadline = chrono :: steady_clock :: now () + chrono :: milliseconds (timeout);
+	vector <long> victimFrames;
+	long block = -1;
+	while (true) {
+
+		// see if there is a free block of frames, and if we are running low, get the cleaner going
+		long whichFrame = freeFrames->allocate (forMe->order);
+		if (whichFrame != -1) {
+			if (freeFrames->getNumFree () < cleanFrames)
+				cleanerWake.notify_one ();
+			frames[whichFrame].page = forMe;
+			policy->admit (whichFrame, forMe->fileId, forMe->pos, fromScan);
+			return whichFrame;
+		}
 
-	// if this is an anon page...
-	if (killMe->myTable == nullptr) {
+		// if we already started emptying a block, keep at it
+		if (block != -1) {
+			claimBlock (block, forMe->order, -1, background, victimFrames);
+			if (victimFrames.size () == 0)
+				block = -1;
+		}
 
-		// recycle him
-		availablePositions.push (killMe->pos);
-		if (killMe->bytes != nullptr) {
-			availableRam.push_back (killMe->bytes);
+		// if not, kick someone out
+		if (victimFrames.size () == 0) {
+			whichFrame = findVictim (background);
+			if (whichFrame != -1) {
+
+				// if he is the same size, the frames change hands while we hold the pool
+				// latch, and the old page is written back after we let go of the latch
+				MyDB_Page *victim = frames[whichFrame].page;
+				if (victim->order == forMe->order) {
+					frames[whichFrame].page = forMe;
+					policy->admit (whichFrame, forMe->fileId, forMe->pos, fromScan);
+					pool.unlock ();
+					kickOutPage (victim);
+					return whichFrame;
+				}
+
+				// otherwise, his frames go back to the buddy allocator; if he is smaller, the
+				// pages next to him go too, so that there will be a block big enough
+				victimFrames.push_back (whichFrame);
+				if (victim->order < forMe->order) {
+					block = whichFrame;
+					claimBlock (whichFrame, forMe->order, whichFrame, background, victimFrames);
+				}
+			}
 		}
 
-		// if he is in the LRU list, remove him
-		if (lastUsed.count (killMe) != 0) {
-			auto page = *(lastUsed.find (killMe));
-			lastUsed.erase (page);
+		if (victimFrames.size () > 0) {
+			pool.unlock ();
+			evictFrames (victimFrames);
+			victimFrames.clear ();
+			pool.lock ();
+			continue;
 		}
 
-	// if this is a pinned, non-anon page whose data is buffered it converts...
-	} else if (lastUsed.count (killMe) == 0 && killMe->bytes != nullptr) {
-		killMe->timeTick = ++lastTimeTick;
-		lastUsed.insert (killMe);
+		// everyone is pinned, so wait for someone to let go of a page, if we are allowed to
+		if (background || timeout <= 0 || chrono :: steady_clock :: now () >= deadline)
+			return -1;
+		frameFreed.wait_until (pool, deadline);
+	}
+}
+
+MyDB_MemoryGrantPtr MyDB_BufferManager :: reserve (size_t numFrames, MyDB_TablePtr forTable) {
+	return getPoolFor (forTable)->reserve (numFrames);
+}
+
+MyDB_MemoryGrantPtr MyDB_BufferManager :: reserve (size_t numFrames) {
+	lock_guard <mutex> pool (poolLatch);
+	if (numFrames == 0 || pinnedFrames + reservedFrames + numFrames > numPages)
+		return nullptr;
+	reservedFrames += numFrames;
+	return MyDB_MemoryGrantPtr (new MyDB_MemoryGrant (*this, numFrames));
+}
+
+size_t MyDB_BufferManager :: getReservableFrames () {
+	lock_guard <mutex> pool (poolLatch);
+	return numPages - pinnedFrames - reservedFrames;
+}
+
+bool MyDB_BufferManager :: chargePin (MyDB_Page *pinMe, const MyDB_GrantFramesPtr &grant) {
 
-	// this guy has no data, so just kill him
-	} else if (killMe->bytes == nullptr) {
-		pair <MyDB_TablePtr, long> whichPage = make_pair (killMe->myTable, killMe->pos);
-		allPages.erase (whichPage);
+	unique_lock <mutex> pool (poolLatch);
+	size_t size = (size_t) 1 << pinMe->order;
+
+	// a pin through a grant only has to fit into what is left of the grant
+	if (grant != nullptr) {
+		if (grant->released || grant->numPinned + size > grant->numFrames)
+			return false;
+		grant->numPinned += size;
+		pinMe->grant = grant;
+		return true;
+	}
+
+	// anyone else has to fit into the frames that are not set aside, and may wait for
+	// a page to be un-pinned (or a grant to go away), as in getFrame
+	auto deadline = chrono :: steady_clock :: now () + chrono :: milliseconds (pinTimeout);
+	while (pinnedFrames + reservedFrames + size > numPages) {
+		if (pinTimeout <= 0 || chrono :: steady_clock :: now () >= deadline)
+			return false;
+		frameFreed.wait_until (pool, deadline);
 	}
+	pinnedFrames += size;
+	return true;
 }
 
-void MyDB_BufferManager :: access (MyDB_PagePtr updateMe) {
-	
-	// if this page was just accessed, get outta here
-	if (updateMe->timeTick > lastTimeTick - (numPages / 2) && updateMe->bytes != nullptr) {
-		return;
+void MyDB_BufferManager :: unchargePin (MyDB_Page *unpinMe) {
+	lock_guard <mutex> pool (poolLatch);
+	size_t size = (size_t) 1 << unpinMe->order;
+	if (unpinMe->grant != nullptr && !unpinMe->grant->released)
+		unpinMe->grant->numPinned -= size;
+	else
+		pinnedFrames -= size;
+	unpinMe->grant = nullptr;
+}
+
+void MyDB_BufferManager :: releaseGrant (const MyDB_GrantFramesPtr &releaseMe) {
+	{
+		lock_guard <mutex> pool (poolLatch);
+		reservedFrames -= releaseMe->numFrames;
+		pinnedFrames += releaseMe->numPinned;
+		releaseMe->released = true;
 	}
+	frameFreed.notify_all ();
+}
 
-	// first, see if it is currently in the LRU list; if it is, update it
-	if (lastUsed.count (updateMe) == 1) {
-		auto page = *(lastUsed.find (updateMe));
-		lastUsed.erase (page);
-		updateMe->timeTick = ++lastTimeTick;
-		lastUsed.insert (updateMe);
+void MyDB_BufferManager :: signalFrameFreed () {
 
-	// here, we don't have the bytes...
-	} else if (updateMe->bytes == nullptr) {
-		
-		// not in the LRU list means that we don't have its contents buffered
-		// see if there is space
-		if (availableRam.size () == 0)
-			kickOutPage ();
+	// grabbing the latch makes sure that a thread that just found no frame is
+	// already waiting by the time that we signal
+	{
+		lock_guard <mutex> guard (poolLatch);
+	}
+	frameFreed.notify_all ();
+}
 
-		// if there is no space, we cannot do anything
-		if (availableRam.size () == 0) {
-			cout << "Can't get any RAM to read a page!!\n";
-			exit (1);
+MyDB_PagePtr MyDB_BufferManager :: erasePage (MyDB_Page *eraseMe) {
+
+	// references are only added with the partition latch held, so if there are still
+	// no references once we have that latch, nobody can find the page any more
+	MyDB_PagePartition &partition = getPartition (eraseMe->fileId, eraseMe->pos);
+	lock_guard <mutex> guard (partition.latch);
+	if (eraseMe->refCount != 0)
+		return nullptr;
+	return partition.pages.erase (eraseMe->fileId, eraseMe->pos, eraseMe);
+}
+
+void MyDB_BufferManager :: killPage (MyDB_Page *killMe) {
+
+	// if this is an anon page... nobody else can ever get to him, so recycle him
+	if (killMe->myTable == nullptr) {
+
+		bool freedFrame = false;
+		{
+			lock_guard <mutex> guard (killMe->latch);
+			if (killMe->pinned) {
+				unchargePin (killMe);
+				killMe->pinned = false;
+				if (trace != nullptr)
+					trace->record (killMe->fileId, killMe->pos, TraceUnpin);
+			}
+			if (killMe->frame != -1) {
+				lock_guard <mutex> pool (poolLatch);
+				frames[killMe->frame].page = nullptr;
+				policy->remove (killMe->frame);
+				freeFrames->free (killMe->frame, killMe->order);
+				killMe->frame = -1;
+				killMe->bytes = nullptr;
+				freedFrame = true;
+			}
 		}
 
+		freeTempPos (killMe);
+		if (freedFrame)
+			signalFrameFreed ();
+		return;
+	}
+
+	MyDB_PagePtr killed;
+	bool unpinned = false;
+	{
+		lock_guard <mutex> guard (killMe->latch);
+
+		// someone got a new handle to this guy in the meantime
+		if (killMe->refCount != 0)
+			return;
+
+		// if this is a pinned, non-anon page whose data is buffered it converts...
+		if (killMe->pinned && killMe->frame != -1) {
+			unchargePin (killMe);
+			killMe->pinned = false;
+			if (trace != nullptr)
+				trace->record (killMe->fileId, killMe->pos, TraceUnpin);
+			policy->touch (killMe->frame);
+			unpinned = true;
+
+		// this guy has no data, so just kill him
+		} else if (killMe->frame == -1) {
+			killed = erasePage (killMe);
+		}
+	}
+
+	if (unpinned)
+		signalFrameFreed ();
+}
+
+void *MyDB_BufferManager :: access (MyDB_Page *updateMe) {
+
+	if (trace != nullptr)
+		trace->record (updateMe->fileId, updateMe->pos, TraceRead);
+	
+	// if the page is buffered, all we need to do is to let the clock know that it was used
+	long whichFrame = updateMe->frame;
+	if (whichFrame != -1) {
+		updateMe->counters->hits.add (1);
+		policy->touch (whichFrame);
+
+		// if the page was marked when it was read ahead, it is time to read further ahead
+		if (updateMe->readAheadMark && updateMe->readAheadMark.exchange (false))
+			readAhead (updateMe, true);
+		return arena->getFrame (whichFrame);
+	}
+
+	// here, we don't have the bytes... so latch the page and read it in, unless
+	// someone else did so while we were waiting for the latch
+	bool missed = false;
+	unique_lock <mutex> guard (updateMe->latch);
+	if (updateMe->frame == -1) {
+
 		// get some RAM for the page
-		updateMe->bytes = availableRam[availableRam.size () - 1]; 
-		updateMe->numBytes = pageSize;
-		availableRam.pop_back ();
+		// (other threads may have every frame pinned; that is not fatal, the caller just can't
+		// have the bytes right now)
+		whichFrame = getFrame (updateMe, false, updateMe->myTable != nullptr && isScanning (updateMe));
+		if (whichFrame == -1)
+			return nullptr;
 
 		// and read it
-		lseek (fds[updateMe->myTable], updateMe->pos * pageSize, SEEK_SET);
-		read (fds[updateMe->myTable], updateMe->bytes, pageSize);
+		updateMe->bytes = arena->getFrame (whichFrame);
+		readPage (updateMe);
+		updateMe->frame = whichFrame;
+		missed = true;
+	} else {
+		updateMe->counters->hits.add (1);
+	}
+
+	void *bytes = updateMe->bytes;
+	guard.unlock ();
+	if (missed && updateMe->myTable != nullptr)
+		readAhead (updateMe, false);
+	return bytes;
+}
+
+bool MyDB_BufferManager :: pinPage (MyDB_Page *pinMe, const MyDB_GrantFramesPtr &grant) {
 
-		updateMe->timeTick = ++lastTimeTick;
-		lastUsed.insert (updateMe);
+	unique_lock <mutex> guard (pinMe->latch);
+
+	// a page that is not pinned yet has to have room to be pinned
+	bool charged = false;
+	if (!pinMe->pinned) {
+		if (!chargePin (pinMe, grant))
+			return false;
+		charged = true;
 	}
+
+	// see if we need to get his data
+	bool missed = false;
+	if (pinMe->frame == -1) {
+
+		// if there is no space, we cannot do anything
+		long whichFrame = getFrame (pinMe, false, pinMe->myTable != nullptr && isScanning (pinMe), charged && grant != nullptr);
+		if (whichFrame == -1) {
+			if (charged)
+				unchargePin (pinMe);
+			return false;
+		}
+
+		// and read it... anonymous pages being pinned for the first time have nothing to read
+		pinMe->bytes = arena->getFrame (whichFrame);
+		if (pinMe->myTable != nullptr) {
+			readPage (pinMe);
+			missed = true;
+		}
+		pinMe->frame = whichFrame;
+	} else {
+		pinMe->counters->hits.add (1);
+	}
+
+	// the clock hand can no longer touch him
+	pinMe->pinned = true;
+	if (trace != nullptr)
+		trace->record (pinMe->fileId, pinMe->pos, TracePin);
+	guard.unlock ();
+
+	// see if we should read ahead of him
+	if (missed)
+		readAhead (pinMe, false);
+	else if (pinMe->readAheadMark && pinMe->readAheadMark.exchange (false))
+		readAhead (pinMe, true);
+	return true;
 }
 
 MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, long i) {
+	MyDB_BufferManager *pool = getPoolFor (whichTable);
+	return pool->getPinnedPage (whichTable, i, nullptr);
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, long i, const MyDB_GrantFramesPtr &grant) {
+
+	// the grant's frames are in this pool, so they can't hold another pool's pages
+	if (getPoolFor (whichTable) != this) {
+		pinFailures++;
+		return nullptr;
+	}
+
+	// first, get a handle to the page
+	MyDB_PageHandle returnVal = getPage (whichTable, i);
+
+	// if there is no space, we cannot do anything; the handle going out of scope
+	// cleans up the page
+	if (!pinPage (returnVal.base.page, grant)) {
+		pinFailures++;
+		return nullptr;
+	}
+
+	// get outta here
+	return returnVal;
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPinnedPage () {
+	return getPinnedPage (pageSize);
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (size_t size) {
+	return spillPool->getPinnedPage (size, nullptr);
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (size_t size, const MyDB_GrantFramesPtr &grant) {
+
+	// get a page to return; it comes from this pool even if anonymous pages usually
+	// go elsewhere, since this is where the grant's frames are
+	MyDB_PageHandle returnVal = getTempPage (size);
+
+	// if there is no space to make a pinned page, we cannot do anything; the
+	// handle going out of scope recycles the temp file position
+	if (!pinPage (returnVal.base.page, grant)) {
+		pinFailures++;
+		return nullptr;
+	}
+
+	// and get outta here
+	return returnVal;
+}
+
+MyDB_PageRangePtr MyDB_BufferManager :: pinRange (MyDB_TablePtr whichTable, long first, long count) {
+	MyDB_BufferManager *pool = getPoolFor (whichTable);
+	return pool->pinRange (whichTable, first, count, nullptr);
+}
+
+MyDB_PageRangePtr MyDB_BufferManager :: pinRange (MyDB_TablePtr whichTable, long first, long count, const MyDB_GrantFramesPtr &grant) {
+
+	// the range can not be bigger than the buffer (or the grant), or in another pool
+	size_t limit = grant == nullptr ? getNumPages () : grant->numFrames;
+	if (getPoolFor (whichTable) != this || count <= 0 || first < 0 || (size_t) count * getPageSize (whichTable) > limit * pageSize) {
+		pinFailures++;
+		return nullptr;
+	}
+
+	// get handles to all of the pages, which keeps them around
+	vector <MyDB_PageHandle> handles;
+	for (long i = 0; i < count; i++)
+		handles.push_back (getPage (whichTable, first + i));
+	size_t fileId = handles[0].base.page->fileId;
+
+	// the pages that were not already pinned, so that they can be let go if we fail
+	vector <MyDB_Page *> pinnedHere;
+	vector <char *> bytes;
+	for (long start = 0; start < count; start += MAX_PIN_RUN) {
+		long end = min (count, start + (long) MAX_PIN_RUN);
+
+		// latch the pages, in file order (as flush does), and get frames for the ones that
+		// are not buffered... they are pinned right away, so they stay where they are
+		vector <pair <MyDB_PagePtr, long>> run;
+		vector <MyDB_Page *> latched;
+		bool failed = false;
+		for (long i = start; i < end && !failed; i++) {
+			MyDB_Page *page = handles[i].base.page;
+			page->latch.lock ();
+			latched.push_back (page);
+			if (page->counters == nullptr)
+				page->counters = getCounters (page->fileId);
+
+			// pages that we pin have to have room to be pinned
+			bool charged = false;
+			if (!page->pinned) {
+				if (!chargePin (page, grant)) {
+					failed = true;
+					break;
+				}
+				charged = true;
+			}
 
-	// open the file, if it is not open
-	if (fds.count (whichTable) == 0) {
-		int fd = open (whichTable->getStorageLoc ().c_str (), O_CREAT | O_RDWR, 0666);
-		fds[whichTable] = fd;
+			if (page->frame == -1) {
+				long whichFrame = getFrame (page, false, false, charged && grant != nullptr);
+				if (whichFrame == -1) {
+					if (charged)
+						unchargePin (page);
+					failed = true;
+					break;
+				}
+				page->bytes = arena->getFrame (whichFrame);
+				page->counters->misses.add (1);
+				run.push_back (make_pair (MyDB_PagePtr (page), whichFrame));
+			} else {
+				page->counters->hits.add (1);
+			}
+			if (!page->pinned) {
+				page->pinned = true;
+				pinnedHere.push_back (page);
+			}
+		}
+
+		// if there were not enough frames, the frames that we got go back, and the pages
+		// that we pinned are let go
+		if (failed) {
+			{
+				lock_guard <mutex> pool (poolLatch);
+				for (auto &read : run) {
+					frames[read.second].page = nullptr;
+					policy->remove (read.second);
+					freeFrames->free (read.second, read.first->order);
+					read.first->bytes = nullptr;
+				}
+			}
+			for (auto page : latched)
+				page->latch.unlock ();
+			for (auto page : pinnedHere) {
+				lock_guard <mutex> guard (page->latch);
+				if (!page->pinned)
+					continue;
+				unchargePin (page);
+				page->pinned = false;
+				if (page->frame != -1)
+					policy->touch (page->frame);
+			}
+			signalFrameFreed ();
+			pinFailures++;
+			return nullptr;
+		}
+
+		// read the pages that were not buffered, a run of consecutive ones at a time (this
+		// lets go of their latches), and let go of the rest
+		int fd = useFd (fileId);
+		vector <pair <MyDB_PagePtr, long>> thisRun;
+		size_t next = 0;
+		for (long i = start; i < end; i++) {
+			MyDB_Page *page = handles[i].base.page;
+			bytes.push_back ((char *) page->bytes);
+			if (next < run.size () && run[next].first.get () == page) {
+				thisRun.push_back (run[next++]);
+			} else {
+				readRun (fd, thisRun, -1);
+				page->latch.unlock ();
+			}
+		}
+		readRun (fd, thisRun, -1);
+		doneWithFd (fileId);
+	}
+
+	// every page in the range was used, and is pinned
+	if (trace != nullptr) {
+		for (auto &handle : handles)
+			trace->record (handle.base.page->fileId, handle.base.page->pos, TracePin);
 	}
 
+	return MyDB_PageRangePtr (new MyDB_PageRange (handles, bytes, getPageSize (whichTable)));
+}
+
+void MyDB_BufferManager :: unpin (MyDB_PagePtr unpinMe) {
+	if (&unpinMe->parent != this) {
+		unpinMe->parent.unpin (unpinMe);
+		return;
+	}
+
+	{
+		lock_guard <mutex> guard (unpinMe->latch);
+		if (unpinMe->pinned) {
+			unchargePin (unpinMe.get ());
+			if (trace != nullptr)
+				trace->record (unpinMe->fileId, unpinMe->pos, TraceUnpin);
+		}
+		unpinMe->pinned = false;
+		if (unpinMe->frame != -1)
+			policy->touch (unpinMe->frame);
+	}
+	signalFrameFreed ();
+}
+
+void MyDB_BufferManager :: prefetch (MyDB_TablePtr whichTable, long firstPage, long numPages) {
+
 	// make sure we don't have a null table
 	if (whichTable == nullptr) {
-		cout << "Can't allocate a page with a null table!!\n";
+		cout << "Can't prefetch pages from a null table!!\n";
 		exit (1);
 	}
 
-	// first, see if the page is there in the buffer
-	pair <MyDB_TablePtr, long> whichPage = make_pair (whichTable, i);
-	MyDB_PagePtr returnVal;
+	MyDB_BufferManager *pool = getPoolFor (whichTable);
+	if (pool != this) {
+		pool->prefetch (whichTable, firstPage, numPages);
+		return;
+	}
 
-	// see if we already know him
-	if (allPages.count (whichPage) == 0) {
+	if (firstPage < 0) {
+		numPages += firstPage;
+		firstPage = 0;
+	}
+	if (numPages <= 0)
+		return;
 
-		// in this case, we do not
-		returnVal = make_shared <MyDB_Page> (whichTable, i, *this);
-		allPages [whichPage] = returnVal;
+	MyDB_PrefetchRequest request;
+	request.table = whichTable;
+	request.fileId = getFileId (whichTable);
+	request.firstPage = firstPage;
+	request.numPages = numPages;
+	request.markPage = -1;
+	queuePrefetch (request);
+}
 
-	// in this case, we do
-	} else {
+void MyDB_BufferManager :: adviseAccess (MyDB_TablePtr whichTable, MyDB_AccessAdvice advice) {
 
-		// get him out of the LRU list if he is there
-		returnVal = allPages [whichPage];
-		if (lastUsed.count (returnVal) != 0) {
-			auto page = *(lastUsed.find (returnVal));
-	       		lastUsed.erase (page);
-		}
+	// make sure we don't have a null table
+	if (whichTable == nullptr) {
+		cout << "Can't advise on a null table!!\n";
+		exit (1);
 	}
 
-	// see if we need to get his data
-	if (returnVal->bytes == nullptr) {
+	MyDB_BufferManager *pool = getPoolFor (whichTable);
+	if (pool != this) {
+		pool->adviseAccess (whichTable, advice);
+		return;
+	}
 
-		// see if there is space to make a pinned page
-		if (availableRam.size () == 0)
-			kickOutPage ();
+	// if the whole table is needed, start reading it now
+	if (advice == WillNeedAccess) {
+		prefetch (whichTable, 0, whichTable->lastPage () + 1);
+		return;
+	}
 
-		// if there is no space, we cannot do anything
-		if (availableRam.size () == 0) 
-			return nullptr;
+	size_t fileId = getFileId (whichTable);
+	lock_guard <mutex> guard (filesLatch);
+	files[fileId].advice = advice;
+	if (files[fileId].fd != -1)
+		adviseKernel (files[fileId]);
+}
+
+bool MyDB_BufferManager :: isScanning (MyDB_Page *readMe) {
+	lock_guard <mutex> guard (filesLatch);
+	MyDB_File &file = files[readMe->fileId];
+	long pos = readMe->pos;
+	if (file.advice == RandomAccess)
+		return false;
+	return file.advice == SequentialAccess || pos == file.lastMiss + 1 || 
+		(pos >= file.readAheadStart && pos <= file.readAheadEnd + 1);
+}
 
-		// set up the return val
-		returnVal->bytes = availableRam[availableRam.size () - 1];
-		returnVal->numBytes = pageSize;
-		availableRam.pop_back ();
+void MyDB_BufferManager :: readAhead (MyDB_Page *justRead, bool markWasSet) {
+
+	MyDB_PrefetchRequest request;
+	{
+		lock_guard <mutex> guard (filesLatch);
+		MyDB_File &file = files[justRead->fileId];
+		if (file.advice == RandomAccess)
+			return;
+
+		// the page is in the most recent read-ahead window if the scan caught up
+		// with the read-ahead, or if it is the marked page in that window
+		long pos = justRead->pos;
+		bool inWindow = pos >= file.readAheadStart && pos <= file.readAheadEnd;
+		bool sequential = markWasSet || inWindow || file.advice == SequentialAccess || pos == file.lastMiss + 1 || 
+			pos == file.readAheadEnd + 1;
+		if (!markWasSet)
+			file.lastMiss = pos;
+		if (!sequential)
+			return;
+
+		// figure out the next window; a table that is being scanned gets a bigger one
+		long window = readAheadPages;
+		if (file.advice == SequentialAccess)
+			window *= 2;
+		long first = inWindow ? file.readAheadEnd + 1 : pos + 1;
+		long last = first + window - 1;
+		if (last > justRead->myTable->lastPage ())
+			last = justRead->myTable->lastPage ();
+		if (first > last)
+			return;
+
+		file.readAheadStart = first;
+		file.readAheadEnd = last;
+		request.table = justRead->myTable;
+		request.fileId = justRead->fileId;
+		request.firstPage = first;
+		request.numPages = last - first + 1;
+		request.markPage = first;
+	}
 
-		// and read it
-		lseek (fds[returnVal->myTable], returnVal->pos * pageSize, SEEK_SET);
-		read (fds[returnVal->myTable], returnVal->bytes, pageSize);
+	queuePrefetch (request);
+}
 
-	}	
+void MyDB_BufferManager :: queuePrefetch (MyDB_PrefetchRequest &request) {
 
-	// get outta here
-	return make_shared <MyDB_PageHandleBase> (returnVal);
+	{
+		lock_guard <mutex> guard (prefetchLatch);
+		if (shuttingDown)
+			return;
+		prefetchRequests.push_back (request);
+
+		// start up the workers the first time that there is something for them to do
+		if (ioWorkers.size () == 0) {
+			for (int i = 0; i < NUM_IO_WORKERS; i++)
+				ioWorkers.push_back (thread (&MyDB_BufferManager :: prefetchWorker, this));
+		}
+	}
+	prefetchReady.notify_one ();
 }
 
-MyDB_PageHandle MyDB_BufferManager :: getPinnedPage () {
+void MyDB_BufferManager :: prefetchWorker () {
 
-	// see if there is space to make a pinned page
-	if (availableRam.size () == 0)
-		kickOutPage ();
+	while (true) {
 
-	// if there is no space, we cannot do anything
-	if (availableRam.size () == 0) 
+		// wait for something to do
+		MyDB_PrefetchRequest request;
+		{
+			unique_lock <mutex> guard (prefetchLatch);
+			while (!shuttingDown && prefetchRequests.size () == 0)
+				prefetchReady.wait (guard);
+			if (shuttingDown)
+				return;
+			request = prefetchRequests.front ();
+			prefetchRequests.pop_front ();
+		}
+
+		// a read-ahead is of no use for the pages that the scan has already gotten past
+		if (request.markPage != -1) {
+			lock_guard <mutex> guard (filesLatch);
+			long lastMiss = files[request.fileId].lastMiss;
+			if (lastMiss >= request.firstPage) {
+				request.numPages -= lastMiss + 1 - request.firstPage;
+				request.firstPage = lastMiss + 1;
+			}
+		}
+
+		// go through the pages, gathering up runs of pages that need to be read
+		int fd = useFd (request.fileId);
+		long end = request.firstPage + request.numPages;
+		bool outOfFrames = false;
+		vector <pair <MyDB_PagePtr, long>> run;
+		for (long pos = request.firstPage; pos < end && !outOfFrames; pos++) {
+
+			long whichFrame;
+			MyDB_PagePtr page = startPrefetch (request, pos, whichFrame, outOfFrames);
+
+			// a page that does not need to be read ends the current run
+			if (page == nullptr) {
+				readRun (fd, run, request.markPage);
+				continue;
+			}
+
+			run.push_back (make_pair (page, whichFrame));
+			if (run.size () == MAX_READ_RUN)
+				readRun (fd, run, request.markPage);
+		}
+		readRun (fd, run, request.markPage);
+		doneWithFd (request.fileId);
+	}
+}
+
+MyDB_PagePtr MyDB_BufferManager :: startPrefetch (MyDB_PrefetchRequest &request, long pos, long &whichFrame, bool &outOfFrames) {
+
+	// find the page, creating it if it is not there
+	MyDB_PagePtr page;
+	{
+		MyDB_PagePartition &partition = getPartition (request.fileId, pos);
+		lock_guard <mutex> guard (partition.latch);
+		MyDB_PagePtr &found = partition.pages.findOrAdd (request.fileId, pos);
+		if (found == nullptr) {
+			size_t size = getPageSize (request.table);
+			found = pagePool.make (request.table, request.fileId, pos, size, getOrder (size), *this);
+		}
+		page = found;
+	}
+
+	// if someone else is working with him, he is taken care of
+	if (page->frame != -1 || !page->latch.try_lock ())
 		return nullptr;
 
-	// get a page to return
-	MyDB_PageHandle returnVal = getPage ();
-	returnVal->page->bytes = availableRam[availableRam.size () - 1];
-	returnVal->page->numBytes = pageSize;
-	availableRam.pop_back ();
+	if (page->frame == -1) {
+		whichFrame = getFrame (page.get (), true, request.markPage != -1);
+		if (whichFrame != -1) {
+			page->bytes = arena->getFrame (whichFrame);
+			return page;
+		}
+		outOfFrames = true;
+	}
 
-	// and get outta here
-	return returnVal;
+	// he does not need to be read after all; if nobody has a handle to him, get rid of him
+	MyDB_PagePtr killed;
+	if (page->frame == -1 && page->refCount == 0)
+		killed = erasePage (page.get ());
+	page->latch.unlock ();
+	return nullptr;
 }
 
-void MyDB_BufferManager :: unpin (MyDB_PagePtr unpinMe) {
-	unpinMe->timeTick = ++lastTimeTick;
-	lastUsed.insert (unpinMe);
+size_t MyDB_BufferManager :: getNumPages () {
+	lock_guard <mutex> pool (poolLatch);
+	return numPages;
+}
+
+// scanned pages get a ring of frames big enough to hold a few windows of pages
+// being read ahead, but never more than half of the buffer
+size_t MyDB_BufferManager :: getRingFrames () {
+	return min ((size_t) 4 * readAheadPages, numPages / 2);
 }
 
-MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn, string tempFileIn) {
+bool MyDB_BufferManager :: grow (size_t n) {
+	{
+		lock_guard <mutex> pool (poolLatch);
+		if (numPages + n > maxPages)
+			return false;
+
+		// bring back the frames that were taken away before using any new ones
+		for (size_t i = 0; i < n; i++) {
+			size_t whichFrame;
+			if (retiredFrames.size () > 0) {
+				whichFrame = retiredFrames.top ();
+				retiredFrames.pop ();
+			} else {
+				whichFrame = frameLimit++;
+			}
+			freeFrames->free (whichFrame, 0);
+		}
+		numPages += n;
+		policy->resize (numPages, frameLimit, getRingFrames ());
+	}
 
-	// remember the inputs
-	pageSize = pageSizeIn;
+	// anyone waiting for a frame can have one now
+	frameFreed.notify_all ();
+	return true;
+}
 
-	// this is the location where we write temp pages
-	tempFile = tempFileIn;
+bool MyDB_BufferManager :: shrink (size_t n) {
+
+	// make sure that there are enough frames that do not hold pinned pages
+	{
+		lock_guard <mutex> pool (poolLatch);
+		if (n >= numPages || numPages - n < reservedFrames + pinnedFrames)
+			return false;
+		size_t unpinned = freeFrames->getNumFree ();
+		for (size_t i = 0; i < frameLimit; i++) {
+			if (frames[i].page != nullptr && !frames[i].page->pinned)
+				unpinned += (size_t) 1 << frames[i].page->order;
+		}
+		if (unpinned < n)
+			return false;
+	}
 
-	// start at time tick zero
-	lastTimeTick = 0;
+	// take free frames one at a time, and kick pages out of others, a batch at a time,
+	// until we have enough... the frames are out of use as soon as we have them, since
+	// they are no longer free and the policy has forgotten about them
+	vector <long> taken;
+	vector <long> victimFrames;
+	while (taken.size () < n) {
+		{
+			lock_guard <mutex> pool (poolLatch);
+			long whichFrame;
+			while (taken.size () < n && (whichFrame = freeFrames->allocate (0)) != -1)
+				taken.push_back (whichFrame);
+			size_t victimSize = 0;
+			while (taken.size () + victimSize < n && victimFrames.size () < MAX_WRITE_RUN) {
+				whichFrame = findVictim (false);
+				if (whichFrame == -1)
+					break;
+				victimFrames.push_back (whichFrame);
+				victimSize += (size_t) 1 << frames[whichFrame].page->order;
+			}
+		}
 
-	// position in temp file
-	lastTempPos = 0;
+		// someone pinned pages in the meantime, so give back what we took
+		if (taken.size () < n && victimFrames.size () == 0) {
+			{
+				lock_guard <mutex> pool (poolLatch);
+				for (long whichFrame : taken)
+					freeFrames->free (whichFrame, 0);
+			}
+			frameFreed.notify_all ();
+			return false;
+		}
 
-	// the number of pages
-	numPages = numPagesIn;
+		// the victims' frames are free once they have been kicked out, and are taken next time around
+		evictFrames (victimFrames);
+		victimFrames.clear ();
+	}
 
-	// create all of the RAM
-	for (size_t i = 0; i < numPages; i++) {
-		availableRam.push_back (malloc (pageSizeIn));
-	}	
+	// and retire them all, giving their RAM back
+	{
+		lock_guard <mutex> pool (poolLatch);
+		for (long whichFrame : taken)
+			retiredFrames.push (whichFrame);
+		numPages -= n;
+		policy->resize (numPages, frameLimit, getRingFrames ());
+	}
+	for (long whichFrame : taken)
+		arena->release (whichFrame);
+	return true;
 }
 
-MyDB_BufferManager :: ~MyDB_BufferManager () {
-	
-	for (auto page : allPages) {
+void MyDB_BufferManager :: evictFrames (vector <long> &victimFrames) {
+
+	// empty the frames first, since the pages may be gone once they are kicked out
+	vector <MyDB_Page *> victims;
+	vector <int> orders;
+	{
+		lock_guard <mutex> pool (poolLatch);
+		for (long whichFrame : victimFrames) {
+			victims.push_back (frames[whichFrame].page);
+			orders.push_back (frames[whichFrame].page->order);
+			frames[whichFrame].page = nullptr;
+		}
+	}
 
-		if (page.second->bytes != nullptr) {
+	// write the dirty ones back, in file order
+	vector <MyDB_Page *> dirty;
+	for (MyDB_Page *victim : victims) {
+		if (victim->isDirty) {
+			victim->isDirty = false;
+			dirty.push_back (victim);
+		}
+	}
+	sort (dirty.begin (), dirty.end (), inFileOrder);
+	writePages (dirty);
+
+	// and finish kicking them out
+	evictions += victims.size ();
+	for (MyDB_Page *victim : victims) {
+		victim->bytes = nullptr;
+		MyDB_PagePtr killed;
+		if (victim->myTable != nullptr && victim->refCount == 0)
+			killed = erasePage (victim);
+		victim->latch.unlock ();
+	}
+
+	// and the frames can be used again
+	lock_guard <mutex> pool (poolLatch);
+	for (size_t i = 0; i < victimFrames.size (); i++)
+		freeFrames->free (victimFrames[i], orders[i]);
+}
 
-			// write it back if necessary
-			if (page.second->isDirty) {
-				lseek (fds[page.second->myTable], page.second->pos * pageSize, SEEK_SET);
-				write (fds[page.second->myTable], page.second->bytes, pageSize);
+void MyDB_BufferManager :: cleanerLoop () {
+
+	vector <long> victimFrames;
+	while (true) {
+
+		// wait until we are running low on free frames... we also check every so often,
+		// since frames can be used up without a request that notices
+		{
+			unique_lock <mutex> pool (poolLatch);
+			cleanerWake.wait_for (pool, chrono :: milliseconds (50), [this] { 
+				return shuttingDown || freeFrames->getNumFree () < cleanFrames; 
+			});
+			if (shuttingDown)
+				return;
+
+			// take frames away from unreferenced pages until there will be enough free ones,
+			// a batch at a time; the pages come back latched
+			size_t victimSize = 0;
+			while (freeFrames->getNumFree () + victimSize < cleanFrames && victimFrames.size () < MAX_WRITE_RUN) {
+				long whichFrame = findVictim (true);
+				if (whichFrame == -1)
+					break;
+				victimFrames.push_back (whichFrame);
+				victimSize += (size_t) 1 << frames[whichFrame].page->order;
 			}
+		}
+
+		evictFrames (victimFrames);
+		if (victimFrames.size () > 0)
+			frameFreed.notify_all ();
+		victimFrames.clear ();
+	}
+}
 
-			free (page.second->bytes);
-			page.second->bytes = nullptr;
+void MyDB_BufferManager :: saveResidentPages () {
+
+	// the policy goes through the frames in the order that it would kick their pages
+	// out, so the later that a frame comes up, the hotter its page is
+	vector <size_t> heat (frameLimit, 0);
+	vector <MyDB_Page *> resident;
+	{
+		lock_guard <mutex> pool (poolLatch);
+		size_t rank = 0;
+		function <bool (size_t)> rankFrame = [&] (size_t frame) {
+			if (heat[frame] == 0)
+				heat[frame] = ++rank;
+			return false;
+		};
+		policy->findVictim (rankFrame);
+		for (size_t i = 0; i < frameLimit; i++) {
+			MyDB_Page *page = frames[i].page;
+			if (page != nullptr && page->myTable != nullptr && page->frame == (long) i)
+				resident.push_back (page);
 		}
 	}
+	sort (resident.begin (), resident.end (), [&heat] (MyDB_Page *lhs, MyDB_Page *rhs) {
+		return heat[lhs->frame] > heat[rhs->frame];
+	});
+
+	// the list goes into a new file that takes the old one's place once it is done, so
+	// that there is always a whole list there
+	string tempName = residentFile + ".tmp";
+	ofstream out (tempName);
+	if (!out)
+		return;
+	out << "MYDBWARM1\n";
+	{
+		lock_guard <mutex> guard (filesLatch);
+		vector <long> tableNums (files.size (), -1);
+		long numTables = 0;
+		for (MyDB_Page *page : resident) {
+			MyDB_File &file = files[page->fileId];
+			if (tableNums[page->fileId] == -1) {
+				tableNums[page->fileId] = numTables++;
+				out << "table " << file.table->getName () << " " << file.fileName << " " << file.pageSize << "\n";
+			}
+			out << "page " << tableNums[page->fileId] << " " << page->pos << " " << heat[page->frame] << "\n";
+		}
+	}
+	out.close ();
+	if (out)
+		rename (tempName.c_str (), residentFile.c_str ());
+	else
+		unlink (tempName.c_str ());
+}
+
+void MyDB_BufferManager :: prewarm () {
 
-	// delete the rest of the RAM
-	for (auto ram : availableRam) {
-		free (ram);
+	ifstream in (residentFile);
+	string word;
+	if (!(in >> word) || word != "MYDBWARM1")
+		return;
+
+	// read the list... tables that can not be read into this buffer, and pages past
+	// the end of their files, are skipped
+	struct WarmPage {
+		size_t heat;
+		size_t table;
+		long pos;
+	};
+	vector <MyDB_TablePtr> tables;
+	vector <WarmPage> pages;
+	while (in >> word) {
+		if (word == "table") {
+			string name, fileName;
+			size_t size;
+			if (!(in >> name >> fileName >> size))
+				break;
+			struct stat info;
+			MyDB_TablePtr table;
+			if (getOrder (size) != -1 && stat (fileName.c_str (), &info) == 0 && (size_t) info.st_size >= size) {
+				table = make_shared <MyDB_Table> (name, fileName);
+				if (size != pageSize)
+					table->setPageSize (size);
+				table->setLastPage (info.st_size / size - 1);
+			}
+			tables.push_back (table);
+		} else if (word == "page") {
+			WarmPage page;
+			if (!(in >> page.table >> page.pos >> page.heat))
+				break;
+			if (page.table < tables.size () && tables[page.table] != nullptr && page.pos <= tables[page.table]->lastPage ())
+				pages.push_back (page);
+		} else {
+			break;
+		}
 	}
 
-	// finally, close the files
-	for (auto fd : fds) {
-		close (fd.second);
+	// keep the hottest pages that fit
+	sort (pages.begin (), pages.end (), [] (const WarmPage &lhs, const WarmPage &rhs) {
+		return lhs.heat > rhs.heat;
+	});
+	size_t numFrames = 0;
+	size_t numKept = 0;
+	for (; numKept < pages.size (); numKept++) {
+		size_t pageFrames = getPageSize (tables[pages[numKept].table]) / pageSize;
+		if (numFrames + pageFrames > numPages)
+			break;
+		numFrames += pageFrames;
+	}
+	pages.resize (numKept);
+
+	// and read them ahead in file order, a run of consecutive pages at a time
+	sort (pages.begin (), pages.end (), [] (const WarmPage &lhs, const WarmPage &rhs) {
+		return lhs.table < rhs.table || (lhs.table == rhs.table && lhs.pos < rhs.pos);
+	});
+	for (size_t i = 0; i < pages.size (); ) {
+		size_t j = i + 1;
+		while (j < pages.size () && pages[j].table == pages[i].table && pages[j].pos == pages[j - 1].pos + 1)
+			j++;
+		prefetch (tables[pages[i].table], pages[i].pos, j - i);
+		i = j;
 	}
+}
 
-	unlink (tempFile.c_str ());
+void MyDB_BufferManager :: readRun (int fd, vector <pair <MyDB_PagePtr, long>> &run, long markPage) {
+
+	if (run.size () == 0)
+		return;
+
+	// read all of the pages at once
+	vector <struct iovec> buffers (run.size ());
+	for (size_t i = 0; i < run.size (); i++) {
+		buffers[i].iov_base = run[i].first->bytes;
+		buffers[i].iov_len = run[i].first->numBytes;
+	}
+	MyDB_IORequest request = {fd, buffers.data (), (int) buffers.size (), (off_t) (run[0].first->pos * run[0].first->numBytes)};
+	chrono :: steady_clock :: time_point start;
+	if (trackLatency)
+		start = chrono :: steady_clock :: now ();
+	ioBackend->read (request);
+	addLatency (readLatency, start);
+	numReads += run.size ();
+	bytesRead += run.size () * run[0].first->numBytes;
+
+	// and let everyone at them
+	for (auto &read : run) {
+		MyDB_Page *page = read.first.get ();
+		if ((long) page->pos == markPage)
+			page->readAheadMark = true;
+		if (page->counters == nullptr)
+			page->counters = getCounters (page->fileId);
+		page->frame = read.second;
+		page->latch.unlock ();
+	}
+	run.clear ();
+}
+
+MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn, string tempFileIn, 
+	MyDB_ReplacementType replacement) : MyDB_BufferManager (pageSizeIn, numPagesIn, tempFileIn, MyDB_BufferOptions (replacement)) {}
+
+MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn, string tempFileIn, MyDB_BufferOptions options) {
+
+	// remember the inputs
+	pageSize = pageSizeIn;
+
+	// this is the location where we write temp pages
+	tempFile = tempFileIn;
+
+	// the number of pages
+	numPages = numPagesIn;
+
+	// by default, do not wait for a frame
+	pinTimeout = 0;
+
+	// nothing is set aside or pinned yet
+	reservedFrames = 0;
+	pinnedFrames = 0;
+
+	// until other pools are added, everything goes in this one
+	spillPool = this;
+	inUse = false;
+
+	// start recording page accesses, if asked to
+	if (options.traceFile != "")
+		trace.reset (new MyDB_AccessTrace (options.traceFile, pageSize));
+	residentFile = options.residentFile;
+
+	// there always has to be room for at least one open file
+	maxOpenFiles = max (options.maxOpenFiles, (size_t) 1);
+	fileOpens = 0;
+
+	// the frames all start at multiples of the page size in the (aligned) arena, and
+	// pages start at multiples of the page size in their files, so it all lines up
+	// for direct I/O as long as the page size does
+	directIO = options.directIO && pageSize % DIRECT_IO_ALIGNMENT == 0;
+
+	// read ahead up to an eighth of the buffer at a time
+	readAheadPages = numPages / 8;
+	if (readAheadPages > 32)
+		readAheadPages = 32;
+	if (readAheadPages < 2)
+		readAheadPages = 2;
+	shuttingDown = false;
+
+	numReads = 0;
+	bytesRead = 0;
+	bytesWritten = 0;
+	evictions = 0;
+	dirtyWriteBacks = 0;
+	pinFailures = 0;
+	trackLatency = options.trackLatency;
+	ioBackend = MyDB_IOBackend :: create (options.ioBackend);
+	maxPages = options.maxPages == 0 ? 4 * numPages : max (options.maxPages, numPages);
+	frameLimit = numPages;
+	policy = MyDB_ReplacementPolicy :: create (options.replacement, maxPages, numPages, getRingFrames ());
+
+	// create all of the RAM, in one piece, with room to grow
+	arena.reset (new MyDB_FrameArena (pageSize, numPages, maxPages, options.hugePages, options.prefault));
+	vector <MyDB_Frame> allFrames (maxPages);
+	frames.swap (allFrames);
+	for (size_t i = 0; i < maxPages; i++)
+		frames[i].page = nullptr;
+	freeFrames.reset (new MyDB_BuddyAllocator (maxPages));
+	for (size_t i = 0; i < numPages; i++)
+		freeFrames->free (i, 0);
+
+	// each spill directory gets a temp file with the same name as the one we were given
+	spillDirs = options.spillDirs;
+	spillPlacement = options.spillPlacement;
+	nextSpill = 0;
+	spillChecks = 0;
+	spillSpace.resize (spillDirs.size ());
+	string tempName = tempFile.substr (tempFile.find_last_of ('/') + 1);
+	for (string &dir : spillDirs)
+		spillFiles.push_back (dir + "/" + tempName);
+	if (spillFiles.size () == 0)
+		spillFiles.push_back (tempFile);
+
+	// file 0 is always the temp file for pages of the buffer's page size (in the first
+	// spill directory); the temp files for the other sizes and directories are set up
+	// as they are needed
+	files.push_back (MyDB_File (nullptr, spillFiles[0], pageSize));
+	tempFiles.resize (freeFrames->getMaxOrder () + 1, vector <MyDB_TempFile> (spillFiles.size ()));
+	tempFiles[0][0].fileId = 0;
+	tempFiles[0][0].counters = files[0].counters.get ();
+
+	// and start the cleaner, if there is to be one
+	cleanFrames = options.cleanFrames;
+	if (cleanFrames > 0)
+		cleaner = thread (&MyDB_BufferManager :: cleanerLoop, this);
+
+	// and start warming up the buffer, if there is a list of pages to warm it up with
+	if (options.prewarm && residentFile != "")
+		prewarm ();
+}
+
+MyDB_BufferManager :: ~MyDB_BufferManager () {
+
+	// stop reading ahead and cleaning; any requests still waiting are dropped
+	{
+		lock_guard <mutex> guard (prefetchLatch);
+		lock_guard <mutex> pool (poolLatch);
+		shuttingDown = true;
+	}
+	prefetchReady.notify_all ();
+	cleanerWake.notify_all ();
+	for (auto &worker : ioWorkers)
+		worker.join ();
+	if (cleaner.joinable ())
+		cleaner.join ();
+
+	// remember what was buffered, for the next buffer manager
+	if (residentFile != "")
+		saveResidentPages ();
+	
+	// write back all of the dirty pages, in file order
+	vector <MyDB_Page *> dirty;
+	for (auto &partition : allPages) {
+		partition.pages.forEach ([&dirty] (MyDB_PagePtr &page) {
+			if (page->frame != -1 && page->isDirty)
+				dirty.push_back (page.get ());
+		});
+	}
+	sort (dirty.begin (), dirty.end (), inFileOrder);
+	writePages (dirty);
+
+	for (auto &partition : allPages) {
+		partition.pages.forEach ([] (MyDB_PagePtr &page) {
+			page->bytes = nullptr;
+			page->frame = -1;
+		});
+	}
+
+	// delete all of the RAM
+	arena.reset ();
+
+	// finally, close the files, and get rid of the temp files
+	for (auto &file : files) {
+		if (file.fd != -1) {
+			ioBackend->closingFile (file.fd);
+			close (file.fd);
+		}
+		if (file.table == nullptr)
+			unlink (file.fileName.c_str ());
+	}
 }
 
 
@@ -0,0 +1,97 @@
+
+#ifndef BUFFER_STATS_C
+#define BUFFER_STATS_C
+
+#include <functional>
+#include "MyDB_BufferStats.h"
+#include <thread>
+
+using namespace std;
+
+size_t MyDB_StripedCounter :: getStripe () {
+	static thread_local size_t stripe = hash <thread :: id> () (this_thread :: get_id ()) % NUM_COUNTER_STRIPES;
+	return stripe;
+}
+
+void MyDB_LatencyCounters :: add (size_t micros) {
+	size_t bucket = 0;
+	while (bucket < NUM_LATENCY_BUCKETS - 1 && micros >= ((size_t) 1 << bucket))
+		bucket++;
+	buckets[bucket].fetch_add (1, memory_order_relaxed);
+	count.fetch_add (1, memory_order_relaxed);
+	totalMicros.fetch_add (micros, memory_order_relaxed);
+}
+
+double MyDB_BufferStats :: hitRate () {
+	if (hits + misses == 0)
+		return 0;
+	return (double) hits / (hits + misses);
+}
+
+// writes out one counter
+static void dumpCounter (ostream &out, string name, string help, size_t value) {
+	out << "# HELP mydb_buffer_" << name << " " << help << "\n";
+	out << "# TYPE mydb_buffer_" << name << " counter\n";
+	out << "mydb_buffer_" << name << " " << value << "\n";
+}
+
+// writes out a histogram; Prometheus wants each bucket to count everything below
+// its upper bound
+static void dumpHistogram (ostream &out, string name, string help, MyDB_LatencyHistogram &histogram) {
+	out << "# HELP mydb_buffer_" << name << " " << help << "\n";
+	out << "# TYPE mydb_buffer_" << name << " histogram\n";
+	size_t total = 0;
+	for (size_t i = 0; i < histogram.buckets.size (); i++) {
+		total += histogram.buckets[i];
+		out << "mydb_buffer_" << name << "_bucket{le=\"";
+		if (i + 1 == histogram.buckets.size ())
+			out << "+Inf";
+		else
+			out << ((size_t) 1 << i);
+		out << "\"} " << total << "\n";
+	}
+	out << "mydb_buffer_" << name << "_sum " << histogram.totalMicros << "\n";
+	out << "mydb_buffer_" << name << "_count " << histogram.count << "\n";
+}
+
+void MyDB_BufferStats :: dump (ostream &out) {
+
+	out << "# HELP mydb_buffer_page_size_bytes The size of each page.\n";
+	out << "# TYPE mydb_buffer_page_size_bytes gauge\n";
+	out << "mydb_buffer_page_size_bytes " << pageSize << "\n";
+	out << "# HELP mydb_buffer_pages The number of pages that the buffer holds.\n";
+	out << "# TYPE mydb_buffer_pages gauge\n";
+	out << "mydb_buffer_pages " << numPages << "\n";
+	out << "# HELP mydb_buffer_temp_pages The size of the temp file, in pages.\n";
+	out << "# TYPE mydb_buffer_temp_pages gauge\n";
+	out << "mydb_buffer_temp_pages " << tempPages << "\n";
+	out << "# HELP mydb_buffer_open_files The files that are open.\n";
+	out << "# TYPE mydb_buffer_open_files gauge\n";
+	out << "mydb_buffer_open_files " << openFiles << "\n";
+
+	dumpCounter (out, "hits_total", "Page accesses that found the page buffered.", hits);
+	dumpCounter (out, "misses_total", "Page accesses that had to read the page in.", misses);
+	dumpCounter (out, "pages_read_total", "Pages read from disk, including the ones read ahead.", pagesRead);
+	dumpCounter (out, "read_bytes_total", "Bytes read from disk.", bytesRead);
+	dumpCounter (out, "written_bytes_total", "Bytes written to disk.", bytesWritten);
+	dumpCounter (out, "evictions_total", "Pages kicked out to make room for other pages.", evictions);
+	dumpCounter (out, "dirty_write_backs_total", "Dirty pages written back.", dirtyWriteBacks);
+	dumpCounter (out, "pin_failures_total", "Requests for pinned pages that failed because every frame was pinned.", pinFailures);
+	dumpCounter (out, "file_opens_total", "Times that a file was opened.", fileOpens);
+
+	out << "# HELP mydb_buffer_table_hits_total Page accesses that found the page buffered, by table.\n";
+	out << "# TYPE mydb_buffer_table_hits_total counter\n";
+	for (auto &table : tables)
+		out << "mydb_buffer_table_hits_total{table=\"" << table.table << "\"} " << table.hits << "\n";
+	out << "# HELP mydb_buffer_table_misses_total Page accesses that had to read the page in, by table.\n";
+	out << "# TYPE mydb_buffer_table_misses_total counter\n";
+	for (auto &table : tables)
+		out << "mydb_buffer_table_misses_total{table=\"" << table.table << "\"} " << table.misses << "\n";
+
+	if (hasLatencies) {
+		dumpHistogram (out, "read_latency_microseconds", "The time taken by each read.", readLatency);
+		dumpHistogram (out, "write_latency_microseconds", "The time taken by each write.", writeLatency);
+	}
+}
+
+#endif
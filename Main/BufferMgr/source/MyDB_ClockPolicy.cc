@@ -0,0 +1,57 @@
+
+#ifndef CLOCK_POLICY_C
+#define CLOCK_POLICY_C
+
+#include "MyDB_ClockPolicy.h"
+
+using namespace std;
+
+MyDB_ClockPolicy :: MyDB_ClockPolicy (size_t maxFrames, size_t numFrames, size_t ringFrames) : 
+	MyDB_ReplacementPolicy (maxFrames, numFrames, ringFrames), refBits (new atomic <bool> [maxFrames]), present (maxFrames, false) {
+	for (size_t i = 0; i < maxFrames; i++)
+		refBits[i] = false;
+	clockHand = 0;
+}
+
+void MyDB_ClockPolicy :: admitPage (size_t frame, size_t, size_t) {
+	present[frame] = true;
+	refBits[frame] = true;
+}
+
+void MyDB_ClockPolicy :: touchPage (size_t frame) {
+	refBits[frame] = true;
+}
+
+void MyDB_ClockPolicy :: removePage (size_t frame) {
+	present[frame] = false;
+}
+
+long MyDB_ClockPolicy :: findPageVictim (function <bool (size_t)> &claim) {
+
+	// sweep the clock hand at most twice around the ring... the first time around
+	// may do nothing but clear reference bits
+	for (size_t swept = 0; swept < 2 * frameLimit; swept++) {
+
+		size_t frame = clockHand;
+		clockHand = (clockHand + 1) % frameLimit;
+		if (!present[frame])
+			continue;
+
+		// this guy was accessed recently, so give him a second chance
+		if (refBits[frame]) {
+			refBits[frame] = false;
+			continue;
+		}
+
+		if (claim (frame)) {
+			present[frame] = false;
+			return frame;
+		}
+	}
+
+	// every single page is pinned or busy
+	return -1;
+}
+
+#endif
+
@@ -0,0 +1,105 @@
+
+#ifndef FRAME_ARENA_C
+#define FRAME_ARENA_C
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "MyDB_FrameArena.h"
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+
+// the size of a (2MB, x86) huge page
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+MyDB_FrameArena :: MyDB_FrameArena (size_t frameSizeIn, size_t numFrames, size_t maxFrames, MyDB_HugePages hugePagesIn, bool prefault) {
+
+	auto start = chrono :: steady_clock :: now ();
+	frameSize = frameSizeIn;
+	hugePages = hugePagesIn;
+	size_t osPageSize = sysconf (_SC_PAGESIZE);
+	size_t bytes = frameSize * maxFrames;
+	mapping = (char *) MAP_FAILED;
+
+	// if there is room for more frames, only the ones in use right away are prefaulted
+	bool populate = prefault && maxFrames == numFrames;
+
+	// first try the explicit huge pages; the mapping has to be a whole number of them
+	if (hugePages == ExplicitHugePages) {
+		mappingSize = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+		mapping = (char *) mmap (nullptr, mappingSize, PROT_READ | PROT_WRITE, 
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (populate ? MAP_POPULATE : 0), -1, 0);
+		base = mapping;
+		if (mapping == MAP_FAILED)
+			hugePages = TransparentHugePages;
+	}
+
+	// transparent huge pages only get used for aligned huge pages, so we map an extra
+	// huge page's worth, and then give back the parts before and after the aligned region
+	if (hugePages == TransparentHugePages) {
+		size_t alignedSize = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+		mapping = (char *) mmap (nullptr, alignedSize + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, 
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (mapping != MAP_FAILED) {
+			char *aligned = (char *) (((size_t) mapping + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+			if (aligned != mapping)
+				munmap (mapping, aligned - mapping);
+			munmap (aligned + alignedSize, mapping + HUGE_PAGE_SIZE - aligned);
+			mapping = base = aligned;
+			mappingSize = alignedSize;
+			madvise (mapping, mappingSize, MADV_HUGEPAGE);
+		}
+	}
+
+	// and regular pages
+	if (hugePages == NoHugePages) {
+		mappingSize = (bytes + osPageSize - 1) / osPageSize * osPageSize;
+		if (mappingSize == 0)
+			mappingSize = osPageSize;
+		mapping = (char *) mmap (nullptr, mappingSize, PROT_READ | PROT_WRITE, 
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | (populate ? MAP_POPULATE : 0), -1, 0);
+		base = mapping;
+	}
+
+	if (mapping == MAP_FAILED) {
+		cout << "Can't map the RAM for the buffer pool!!\n";
+		exit (1);
+	}
+
+	// MAP_POPULATE does not go through the huge page advice (and cannot do just part of
+	// the mapping), so in those cases, touch every page by hand
+	if (prefault && (!populate || hugePages == TransparentHugePages)) {
+		for (size_t i = 0; i < frameSize * numFrames; i += osPageSize)
+			base[i] = 0;
+	}
+
+	setupTime = chrono :: duration <double> (chrono :: steady_clock :: now () - start).count ();
+}
+
+MyDB_FrameArena :: ~MyDB_FrameArena () {
+	munmap (mapping, mappingSize);
+}
+
+void MyDB_FrameArena :: release (size_t i) {
+
+	// RAM is given back a whole page at a time, so only the pages that are entirely
+	// inside of the frame can go... the rest may be shared with frames still in use
+	size_t pageSize = hugePages == ExplicitHugePages ? HUGE_PAGE_SIZE : sysconf (_SC_PAGESIZE);
+	size_t start = ((size_t) getFrame (i) + pageSize - 1) / pageSize * pageSize;
+	size_t end = ((size_t) getFrame (i) + frameSize) / pageSize * pageSize;
+	if (start < end)
+		madvise ((void *) start, end - start, MADV_DONTNEED);
+}
+
+MyDB_HugePages MyDB_FrameArena :: getHugePages () {
+	return hugePages;
+}
+
+double MyDB_FrameArena :: getSetupTime () {
+	return setupTime;
+}
+
+#endif
+
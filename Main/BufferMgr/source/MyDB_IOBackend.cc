@@ -0,0 +1,28 @@
+
+#ifndef IO_BACKEND_C
+#define IO_BACKEND_C
+
+#include "MyDB_IOBackend.h"
+#include "MyDB_MmapBackend.h"
+#include "MyDB_PReadBackend.h"
+#include "MyDB_URingBackend.h"
+
+using namespace std;
+
+MyDB_IOBackendPtr MyDB_IOBackend :: create (MyDB_IOBackendType type) {
+	switch (type) {
+		case URingBackend: return make_shared <MyDB_URingBackend> ();
+		case MmapBackend: return make_shared <MyDB_MmapBackend> ();
+		default: return make_shared <MyDB_PReadBackend> ();
+	}
+}
+
+void MyDB_IOBackend :: openedFile (int) {}
+
+void MyDB_IOBackend :: closingFile (int) {}
+
+void MyDB_IOBackend :: truncatedFile (int, size_t) {}
+
+MyDB_IOBackend :: ~MyDB_IOBackend () {}
+
+#endif
@@ -0,0 +1,89 @@
+
+#ifndef LRUK_POLICY_C
+#define LRUK_POLICY_C
+
+#include <algorithm>
+#include "MyDB_LRUKPolicy.h"
+
+using namespace std;
+
+MyDB_LRUKPolicy :: MyDB_LRUKPolicy (size_t maxFrames, size_t numFrames, size_t ringFrames) : 
+	MyDB_ReplacementPolicy (maxFrames, numFrames, ringFrames), last (maxFrames, 0), prev (maxFrames, 0), 
+	keys (maxFrames), present (maxFrames, false) {
+	now = 0;
+	lastTouched = -1;
+}
+
+void MyDB_LRUKPolicy :: admitPage (size_t frame, size_t fileId, size_t pageNo) {
+	lock_guard <mutex> guard (latch);
+
+	// see if we remember this guy
+	size_t key = pageKey (fileId, pageNo);
+	auto found = ghosts.find (key);
+	if (found != ghosts.end ()) {
+		prev[frame] = found->second.last;
+		ghostOrder.erase (found->second.where);
+		ghosts.erase (found);
+	} else {
+		prev[frame] = 0;
+	}
+
+	last[frame] = ++now;
+	keys[frame] = key;
+	present[frame] = true;
+	lastTouched = frame;
+}
+
+void MyDB_LRUKPolicy :: touchPage (size_t frame) {
+	lock_guard <mutex> guard (latch);
+	if (!present[frame] || lastTouched == (long) frame)
+		return;
+	prev[frame] = last[frame];
+	last[frame] = ++now;
+	lastTouched = frame;
+}
+
+void MyDB_LRUKPolicy :: removePage (size_t frame) {
+	lock_guard <mutex> guard (latch);
+	present[frame] = false;
+}
+
+long MyDB_LRUKPolicy :: findPageVictim (function <bool (size_t)> &claim) {
+	lock_guard <mutex> guard (latch);
+
+	// order the frames by their second-to-last use, then by their last use
+	vector <size_t> order;
+	for (size_t i = 0; i < frameLimit; i++) {
+		if (present[i])
+			order.push_back (i);
+	}
+	sort (order.begin (), order.end (), [this] (size_t lhs, size_t rhs) {
+		if (prev[lhs] != prev[rhs])
+			return prev[lhs] < prev[rhs];
+		return last[lhs] < last[rhs];
+	});
+
+	for (size_t frame : order) {
+		if (!claim (frame))
+			continue;
+
+		// remember his history, forgetting the oldest history if we have too much
+		ghostOrder.push_back (keys[frame]);
+		History &history = ghosts[keys[frame]];
+		history.last = last[frame];
+		history.prev = prev[frame];
+		history.where = ghostOrder.end ();
+		history.where--;
+		if (ghostOrder.size () > numFrames) {
+			ghosts.erase (ghostOrder.front ());
+			ghostOrder.pop_front ();
+		}
+
+		present[frame] = false;
+		return frame;
+	}
+	return -1;
+}
+
+#endif
+
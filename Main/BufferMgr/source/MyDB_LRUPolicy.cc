@@ -0,0 +1,47 @@
+
+#ifndef LRU_POLICY_C
+#define LRU_POLICY_C
+
+#include "MyDB_LRUPolicy.h"
+
+using namespace std;
+
+MyDB_LRUPolicy :: MyDB_LRUPolicy (size_t maxFrames, size_t numFrames, size_t ringFrames) : 
+	MyDB_ReplacementPolicy (maxFrames, numFrames, ringFrames), where (maxFrames), present (maxFrames, false) {}
+
+void MyDB_LRUPolicy :: admitPage (size_t frame, size_t, size_t) {
+	lock_guard <mutex> guard (latch);
+	lru.push_front (frame);
+	where[frame] = lru.begin ();
+	present[frame] = true;
+}
+
+void MyDB_LRUPolicy :: touchPage (size_t frame) {
+	lock_guard <mutex> guard (latch);
+	if (present[frame])
+		lru.splice (lru.begin (), lru, where[frame]);
+}
+
+void MyDB_LRUPolicy :: removePage (size_t frame) {
+	lock_guard <mutex> guard (latch);
+	if (present[frame]) {
+		lru.erase (where[frame]);
+		present[frame] = false;
+	}
+}
+
+long MyDB_LRUPolicy :: findPageVictim (function <bool (size_t)> &claim) {
+	lock_guard <mutex> guard (latch);
+	for (auto it = lru.rbegin (); it != lru.rend (); it++) {
+		size_t frame = *it;
+		if (claim (frame)) {
+			lru.erase (where[frame]);
+			present[frame] = false;
+			return frame;
+		}
+	}
+	return -1;
+}
+
+#endif
+
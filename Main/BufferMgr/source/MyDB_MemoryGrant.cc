@@ -0,0 +1,47 @@
+
+#ifndef MEMORY_GRANT_C
+#define MEMORY_GRANT_C
+
+#include "MyDB_BufferManager.h"
+#include "MyDB_MemoryGrant.h"
+
+using namespace std;
+
+MyDB_MemoryGrant :: MyDB_MemoryGrant (MyDB_BufferManager &parentIn, size_t numFrames) : parent (parentIn) {
+	frames = make_shared <MyDB_GrantFrames> ();
+	frames->numFrames = numFrames;
+	frames->numPinned = 0;
+	frames->released = false;
+}
+
+MyDB_MemoryGrant :: ~MyDB_MemoryGrant () {
+	parent.releaseGrant (frames);
+}
+
+size_t MyDB_MemoryGrant :: getNumFrames () {
+	return frames->numFrames;
+}
+
+size_t MyDB_MemoryGrant :: getNumPinned () {
+	lock_guard <mutex> pool (parent.poolLatch);
+	return frames->numPinned;
+}
+
+MyDB_PageHandle MyDB_MemoryGrant :: getPinnedPage (MyDB_TablePtr whichTable, long i) {
+	return parent.getPinnedPage (whichTable, i, frames);
+}
+
+MyDB_PageHandle MyDB_MemoryGrant :: getPinnedPage () {
+	return parent.getPinnedPage (parent.getPageSize (), frames);
+}
+
+MyDB_PageHandle MyDB_MemoryGrant :: getPinnedPage (size_t pageSize) {
+	return parent.getPinnedPage (pageSize, frames);
+}
+
+MyDB_PageRangePtr MyDB_MemoryGrant :: pinRange (MyDB_TablePtr whichTable, long first, long count) {
+	return parent.pinRange (whichTable, first, count, frames);
+}
+
+#endif
+
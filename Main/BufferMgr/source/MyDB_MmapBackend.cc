@@ -0,0 +1,99 @@
+
+#ifndef MMAP_BACKEND_C
+#define MMAP_BACKEND_C
+
+#include <algorithm>
+#include <cstring>
+#include "MyDB_MmapBackend.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// the smallest mapping that is made of a file
+#define MIN_MAPPING_SIZE (16 * 1024 * 1024)
+
+MyDB_MmapBackend :: ~MyDB_MmapBackend () {
+	for (auto &file : files)
+		unmap (file.second);
+}
+
+void MyDB_MmapBackend :: unmap (MappedFile &file) {
+	for (auto &mapping : file.mappings)
+		munmap (mapping.bytes, mapping.size);
+	file.mappings.clear ();
+}
+
+bool MyDB_MmapBackend :: getMapping (int fd, size_t end, char *&bytes) {
+
+	lock_guard <mutex> guard (latch);
+	MappedFile &file = files[fd];
+
+	// the file may have grown since we last looked... it is not safe to touch the
+	// mapping past the end of the file
+	if (end > file.fileSize) {
+		struct stat fileInfo;
+		if (fstat (fd, &fileInfo) != 0)
+			return false;
+		file.fileSize = fileInfo.st_size;
+		if (end > file.fileSize)
+			return false;
+	}
+
+	// make a bigger mapping if this one does not reach far enough
+	if (file.mappings.size () == 0 || file.mappings.back ().size < end) {
+		size_t osPageSize = sysconf (_SC_PAGESIZE);
+		size_t size = max (file.fileSize * 2, (size_t) MIN_MAPPING_SIZE);
+		size = (size + osPageSize - 1) / osPageSize * osPageSize;
+		void *mapping = mmap (nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+		if (mapping == MAP_FAILED)
+			return false;
+		file.mappings.push_back (Mapping {(char *) mapping, size});
+	}
+
+	bytes = file.mappings.back ().bytes;
+	return true;
+}
+
+void MyDB_MmapBackend :: read (MyDB_IORequest &request) {
+
+	size_t length = 0;
+	for (int i = 0; i < request.numBuffers; i++)
+		length += request.buffers[i].iov_len;
+
+	// if the run is not all there in the file, read it normally to get what there is
+	char *bytes;
+	if (!getMapping (request.fd, request.offset + length, bytes)) {
+		MyDB_PReadBackend :: read (request);
+		return;
+	}
+
+	bytes += request.offset;
+	for (int i = 0; i < request.numBuffers; i++) {
+		memcpy (request.buffers[i].iov_base, bytes, request.buffers[i].iov_len);
+		bytes += request.buffers[i].iov_len;
+	}
+}
+
+void MyDB_MmapBackend :: closingFile (int fd) {
+	lock_guard <mutex> guard (latch);
+	auto found = files.find (fd);
+	if (found != files.end ()) {
+		unmap (found->second);
+		files.erase (found);
+	}
+}
+
+void MyDB_MmapBackend :: truncatedFile (int fd, size_t size) {
+	lock_guard <mutex> guard (latch);
+	auto found = files.find (fd);
+	if (found != files.end ())
+		found->second.fileSize = min (found->second.fileSize, size);
+}
+
+MyDB_IOBackendType MyDB_MmapBackend :: getType () {
+	return MmapBackend;
+}
+
+#endif
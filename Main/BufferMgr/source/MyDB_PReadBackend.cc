@@ -0,0 +1,23 @@
+
+#ifndef PREAD_BACKEND_C
+#define PREAD_BACKEND_C
+
+#include "MyDB_PReadBackend.h"
+#include <unistd.h>
+
+using namespace std;
+
+void MyDB_PReadBackend :: read (MyDB_IORequest &request) {
+	preadv (request.fd, request.buffers, request.numBuffers, request.offset);
+}
+
+void MyDB_PReadBackend :: write (vector <MyDB_IORequest> &requests) {
+	for (auto &request : requests)
+		pwritev (request.fd, request.buffers, request.numBuffers, request.offset);
+}
+
+MyDB_IOBackendType MyDB_PReadBackend :: getType () {
+	return PReadBackend;
+}
+
+#endif
@@ -16,27 +16,38 @@
 #include "MyDB_Page.h"
 #include "MyDB_Table.h"
 
-void *MyDB_Page :: getBytes (MyDB_PagePtr me) {
-	parent.access (me);	
-	return bytes;
+void *MyDB_Page :: getBytes () {
+	return parent.access (this);
 }
 
 void MyDB_Page :: wroteBytes () {
 	isDirty = true;
+	if (parent.trace != nullptr)
+		parent.trace->record (fileId, pos, TraceWrite);
 }
 
 MyDB_Page :: ~MyDB_Page () {}
 
-MyDB_Page :: MyDB_Page (MyDB_TablePtr myTableIn, size_t iin, MyDB_BufferManager &parentIn) : 
-	parent (parentIn), myTable (myTableIn), pos (iin) { 
+MyDB_Page :: MyDB_Page (MyDB_TablePtr myTableIn, size_t fileIdIn, size_t iin, size_t numBytesIn, int orderIn, 
+	MyDB_BufferManager &parentIn) : numBytes (numBytesIn), order (orderIn), parent (parentIn), myTable (myTableIn), 
+	fileId (fileIdIn), pos (iin) { 
 	bytes = nullptr;
 	isDirty = false;	
+	onDisk = false;
 	refCount = 0;
-	timeTick = -1;
+	ptrCount = 0;
+	frame = -1;
+	pinned = false;
+	readAheadMark = false;
+	counters = nullptr;
 }
 
-void MyDB_Page :: killpage (MyDB_PagePtr me) {
-	parent.killPage (me);
+void MyDB_Page :: killpage () {
+	parent.killPage (this);
+}
+
+void MyDB_Page :: recycle () {
+	parent.pagePool.recycle (this);
 }
 
 MyDB_BufferManager &MyDB_Page :: getParent () {
@@ -0,0 +1,60 @@
+
+#ifndef PAGE_POOL_C
+#define PAGE_POOL_C
+
+#include "MyDB_PagePool.h"
+
+#ifdef __SANITIZE_THREAD__
+#include <sanitizer/tsan_interface.h>
+#endif
+
+using namespace std;
+
+MyDB_PagePtr MyDB_PagePool :: make (MyDB_TablePtr myTable, size_t fileId, size_t i, size_t numBytes, int order,
+	MyDB_BufferManager &parent) {
+
+	PageMemory *memory;
+	{
+		lock_guard <mutex> guard (latch);
+
+		// if there is no memory put aside, get another chunk... there is always room
+		// in spare for all of the memory, so recycling a page does not touch the heap
+		if (spare.size () == 0) {
+			chunks.emplace_back (new PageMemory[PAGE_POOL_CHUNK]);
+			spare.reserve (chunks.size () * PAGE_POOL_CHUNK);
+			for (size_t j = PAGE_POOL_CHUNK; j > 0; j--)
+				spare.push_back (&chunks.back ()[j - 1]);
+		}
+		memory = spare.back ();
+		spare.pop_back ();
+	}
+
+	// the page is built outside of the latch
+	return MyDB_PagePtr (new (memory) MyDB_Page (myTable, fileId, i, numBytes, order, parent));
+}
+
+void MyDB_PagePool :: recycle (MyDB_Page *recycleMe) {
+
+#ifdef __SANITIZE_THREAD__
+	// destroying a mutex does nothing, so the thread sanitizer has to be told that the
+	// page's latch is gone; otherwise it takes the next page's latch to be the same one
+	__tsan_mutex_destroy (&recycleMe->latch, 0);
+#endif
+
+	recycleMe->~MyDB_Page ();
+	lock_guard <mutex> guard (latch);
+	spare.push_back ((PageMemory *) recycleMe);
+}
+
+size_t MyDB_PagePool :: getCapacity () {
+	lock_guard <mutex> guard (latch);
+	return chunks.size () * PAGE_POOL_CHUNK;
+}
+
+size_t MyDB_PagePool :: getNumInUse () {
+	lock_guard <mutex> guard (latch);
+	return chunks.size () * PAGE_POOL_CHUNK - spare.size ();
+}
+
+#endif
+
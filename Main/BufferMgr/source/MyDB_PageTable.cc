@@ -0,0 +1,95 @@
+
+#ifndef PAGE_TABLE_C
+#define PAGE_TABLE_C
+
+#include "MyDB_PageTable.h"
+
+MyDB_PageTable :: MyDB_PageTable () {
+	slots.resize (64);
+	numUsed = 0;
+}
+
+size_t MyDB_PageTable :: probe (size_t fileId, size_t pageNo) {
+	size_t mask = slots.size () - 1;
+	size_t pos = hash (fileId, pageNo) & mask;
+	while (slots[pos].page != nullptr && (slots[pos].fileId != fileId || slots[pos].pageNo != pageNo)) {
+		pos = (pos + 1) & mask;
+	}
+	return pos;
+}
+
+MyDB_PagePtr &MyDB_PageTable :: findOrAdd (size_t fileId, size_t pageNo) {
+
+	// keep the load factor under 1/2, so that probe sequences stay short
+	if (2 * (numUsed + 1) > slots.size ())
+		grow ();
+
+	size_t pos = probe (fileId, pageNo);
+	if (slots[pos].page == nullptr) {
+
+		// this is a new page, which the caller is going to fill in
+		slots[pos].fileId = fileId;
+		slots[pos].pageNo = pageNo;
+		numUsed++;
+	}
+	return slots[pos].page;
+}
+
+MyDB_PagePtr MyDB_PageTable :: find (size_t fileId, size_t pageNo) {
+	return slots[probe (fileId, pageNo)].page;
+}
+
+MyDB_PagePtr MyDB_PageTable :: erase (size_t fileId, size_t pageNo, MyDB_Page *onlyMe) {
+
+	size_t mask = slots.size () - 1;
+	size_t pos = probe (fileId, pageNo);
+	if (slots[pos].page == nullptr || (onlyMe != nullptr && slots[pos].page.get () != onlyMe))
+		return nullptr;
+
+	MyDB_PagePtr returnVal = std :: move (slots[pos].page);
+	slots[pos].page = nullptr;
+	numUsed--;
+
+	// shift back any later entry in the probe sequence that would no longer be reachable
+	size_t hole = pos;
+	for (size_t next = (pos + 1) & mask; slots[next].page != nullptr; next = (next + 1) & mask) {
+		size_t home = hash (slots[next].fileId, slots[next].pageNo) & mask;
+
+		// the entry can move to the hole iff its home is not cyclically in (hole, next]
+		if (((next - home) & mask) >= ((next - hole) & mask)) {
+			slots[hole] = std :: move (slots[next]);
+			slots[next].page = nullptr;
+			hole = next;
+		}
+	}
+	return returnVal;
+}
+
+void MyDB_PageTable :: grow () {
+
+	vector <Slot> oldSlots;
+	oldSlots.swap (slots);
+	slots.resize (oldSlots.size () * 2);
+	numUsed = 0;
+	for (auto &slot : oldSlots) {
+		if (slot.page != nullptr) {
+			size_t pos = probe (slot.fileId, slot.pageNo);
+			slots[pos] = std :: move (slot);
+			numUsed++;
+		}
+	}
+}
+
+void MyDB_PageTable :: forEach (function <void (MyDB_PagePtr &)> doMe) {
+	for (auto &slot : slots) {
+		if (slot.page != nullptr)
+			doMe (slot.page);
+	}
+}
+
+size_t MyDB_PageTable :: size () {
+	return numUsed;
+}
+
+#endif
+
@@ -0,0 +1,122 @@
+
+#ifndef REPLACEMENT_POLICY_C
+#define REPLACEMENT_POLICY_C
+
+#include <algorithm>
+#include "MyDB_ARCPolicy.h"
+#include "MyDB_ClockPolicy.h"
+#include "MyDB_LRUKPolicy.h"
+#include "MyDB_LRUPolicy.h"
+#include "MyDB_ReplacementPolicy.h"
+#include "MyDB_TwoQPolicy.h"
+
+using namespace std;
+
+MyDB_ReplacementPolicyPtr MyDB_ReplacementPolicy :: create (MyDB_ReplacementType type, size_t maxFrames, size_t numFrames, size_t ringFrames) {
+	switch (type) {
+		case LRUReplacement: return make_shared <MyDB_LRUPolicy> (maxFrames, numFrames, ringFrames);
+		case LRUKReplacement: return make_shared <MyDB_LRUKPolicy> (maxFrames, numFrames, ringFrames);
+		case TwoQReplacement: return make_shared <MyDB_TwoQPolicy> (maxFrames, numFrames, ringFrames);
+		case ARCReplacement: return make_shared <MyDB_ARCPolicy> (maxFrames, numFrames, ringFrames);
+		default: return make_shared <MyDB_ClockPolicy> (maxFrames, numFrames, ringFrames);
+	}
+}
+
+MyDB_ReplacementPolicy :: MyDB_ReplacementPolicy (size_t maxFrames, size_t numFramesIn, size_t ringFramesIn) : 
+	numFrames (numFramesIn), frameLimit (numFramesIn), inRing (new atomic <bool> [maxFrames]), 
+	ringUses (new atomic <int> [maxFrames]), ringPages (maxFrames), ringFrames (ringFramesIn) {
+	for (size_t i = 0; i < maxFrames; i++) {
+		inRing[i] = false;
+		ringUses[i] = 0;
+	}
+	lastRingTouch = -1;
+}
+
+MyDB_ReplacementPolicy :: ~MyDB_ReplacementPolicy () {}
+
+void MyDB_ReplacementPolicy :: resize (size_t numFramesIn, size_t frameLimitIn, size_t ringFramesIn) {
+	numFrames = numFramesIn;
+	frameLimit = frameLimitIn;
+	ringFrames = ringFramesIn;
+	resized ();
+}
+
+void MyDB_ReplacementPolicy :: resized () {}
+
+size_t MyDB_ReplacementPolicy :: pageKey (size_t fileId, size_t pageNo) {
+	return (fileId << 40) ^ pageNo;
+}
+
+void MyDB_ReplacementPolicy :: admit (size_t frame, size_t fileId, size_t pageNo, bool fromScan) {
+	if (fromScan && ringFrames > 0) {
+		ring.push_back (frame);
+		ringPages[frame] = make_pair (fileId, pageNo);
+		ringUses[frame] = 0;
+		inRing[frame] = true;
+	} else {
+		admitPage (frame, fileId, pageNo);
+	}
+}
+
+void MyDB_ReplacementPolicy :: touch (size_t frame) {
+
+	// the scan using a page over and over does not make it any more likely to be
+	// used again, but coming back to the page later does
+	if (inRing[frame]) {
+		if (lastRingTouch.exchange (frame) != (long) frame)
+			ringUses[frame]++;
+		return;
+	}
+	touchPage (frame);
+}
+
+void MyDB_ReplacementPolicy :: remove (size_t frame) {
+	if (inRing[frame]) {
+		ring.erase (find (ring.begin (), ring.end (), frame));
+		inRing[frame] = false;
+	} else {
+		removePage (frame);
+	}
+}
+
+long MyDB_ReplacementPolicy :: findRingVictim (function <bool (size_t)> &claim) {
+	for (auto it = ring.begin (); it != ring.end ();) {
+		size_t frame = *it;
+
+		// the page was used once by the scan, and then again later, so it is not just
+		// part of the scan... let the actual policy take care of him from now on
+		if (ringUses[frame] >= 2) {
+			it = ring.erase (it);
+			inRing[frame] = false;
+			admitPage (frame, ringPages[frame].first, ringPages[frame].second);
+			continue;
+		}
+
+		if (claim (frame)) {
+			ring.erase (it);
+			inRing[frame] = false;
+			return frame;
+		}
+		it++;
+	}
+	return -1;
+}
+
+long MyDB_ReplacementPolicy :: findVictim (function <bool (size_t)> &claim) {
+
+	// once the ring is full, the scan reuses its own frames
+	long victim = -1;
+	if (ring.size () >= ringFrames)
+		victim = findRingVictim (claim);
+
+	// otherwise, ask the actual policy... and if every page that it has is busy, we
+	// can always fall back on the ring
+	if (victim == -1)
+		victim = findPageVictim (claim);
+	if (victim == -1)
+		victim = findRingVictim (claim);
+	return victim;
+}
+
+#endif
+
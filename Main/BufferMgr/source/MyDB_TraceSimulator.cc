@@ -0,0 +1,148 @@
+
+#ifndef TRACE_SIMULATOR_C
+#define TRACE_SIMULATOR_C
+
+#include <limits>
+#include "MyDB_TraceSimulator.h"
+#include <set>
+#include <unordered_map>
+
+using namespace std;
+
+MyDB_TraceSimulator :: MyDB_TraceSimulator (vector <MyDB_TraceEntry> &entriesIn) {
+	entries.swap (entriesIn);
+
+	// number the pages in the order that they first show up
+	unordered_map <uint64_t, size_t> ids;
+	numAccesses = 0;
+	for (auto &entry : entries) {
+		uint64_t key = ((uint64_t) entry.fileId << 32) | entry.pageNo;
+		auto found = ids.find (key);
+		if (found == ids.end ())
+			found = ids.insert (make_pair (key, ids.size ())).first;
+		pageIds.push_back (found->second);
+		if (isAccess (entry))
+			numAccesses++;
+	}
+	numPages = ids.size ();
+}
+
+bool MyDB_TraceSimulator :: isAccess (MyDB_TraceEntry &entry) {
+	return entry.kind == TraceRead || entry.kind == TracePin;
+}
+
+size_t MyDB_TraceSimulator :: getNumAccesses () {
+	return numAccesses;
+}
+
+size_t MyDB_TraceSimulator :: getNumPages () {
+	return numPages;
+}
+
+size_t MyDB_TraceSimulator :: simulate (MyDB_ReplacementType type, size_t numFrames) {
+
+	MyDB_ReplacementPolicyPtr policy = MyDB_ReplacementPolicy :: create (type, numFrames, numFrames, 0);
+	vector <long> frameOf (numPages, -1);
+	vector <size_t> pageIn (numFrames);
+	vector <bool> pinned (numPages, false);
+	function <bool (size_t)> claim = [&] (size_t frame) {
+		return !pinned[pageIn[frame]];
+	};
+
+	size_t nextFree = 0;
+	size_t misses = 0;
+	for (size_t i = 0; i < entries.size (); i++) {
+		MyDB_TraceEntry &entry = entries[i];
+		size_t page = pageIds[i];
+		if (entry.kind == TraceUnpin) {
+			pinned[page] = false;
+			continue;
+		}
+		if (!isAccess (entry))
+			continue;
+
+		// a hit just lets the policy know
+		if (frameOf[page] != -1) {
+			policy->touch (frameOf[page]);
+
+		// on a miss, the page gets a free frame, or the one that the policy picks
+		} else {
+			misses++;
+			long frame;
+			if (nextFree < numFrames) {
+				frame = nextFree++;
+			} else {
+				frame = policy->findVictim (claim);
+				if (frame == -1)
+					continue;
+				frameOf[pageIn[frame]] = -1;
+			}
+			pageIn[frame] = page;
+			frameOf[page] = frame;
+			policy->admit (frame, entry.fileId, entry.pageNo, false);
+		}
+
+		if (entry.kind == TracePin)
+			pinned[page] = true;
+	}
+	return misses;
+}
+
+size_t MyDB_TraceSimulator :: simulateOptimal (size_t numFrames) {
+
+	// find the next time that each entry's page is used
+	const size_t never = numeric_limits <size_t> :: max ();
+	vector <size_t> nextUse (entries.size (), never);
+	vector <size_t> lastSeen (numPages, never);
+	for (size_t i = entries.size (); i > 0; i--) {
+		if (!isAccess (entries[i - 1]))
+			continue;
+		nextUse[i - 1] = lastSeen[pageIds[i - 1]];
+		lastSeen[pageIds[i - 1]] = i - 1;
+	}
+
+	// the buffered pages, by when they are next used (the latest first)
+	set <pair <size_t, size_t>, greater <pair <size_t, size_t>>> buffered;
+	vector <size_t> usedNext (numPages, never);
+	vector <bool> isBuffered (numPages, false);
+	vector <bool> pinned (numPages, false);
+
+	size_t misses = 0;
+	for (size_t i = 0; i < entries.size (); i++) {
+		MyDB_TraceEntry &entry = entries[i];
+		size_t page = pageIds[i];
+		if (entry.kind == TraceUnpin) {
+			pinned[page] = false;
+			continue;
+		}
+		if (!isAccess (entry))
+			continue;
+
+		if (isBuffered[page]) {
+			buffered.erase (make_pair (usedNext[page], page));
+		} else {
+			misses++;
+
+			// kick out the unpinned page that is used last
+			if (buffered.size () == numFrames) {
+				auto victim = buffered.begin ();
+				while (victim != buffered.end () && pinned[victim->second])
+					victim++;
+				if (victim == buffered.end ())
+					continue;
+				isBuffered[victim->second] = false;
+				buffered.erase (victim);
+			}
+			isBuffered[page] = true;
+		}
+		usedNext[page] = nextUse[i];
+		buffered.insert (make_pair (usedNext[page], page));
+
+		if (entry.kind == TracePin)
+			pinned[page] = true;
+	}
+	return misses;
+}
+
+#endif
+
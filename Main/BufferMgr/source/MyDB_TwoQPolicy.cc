@@ -0,0 +1,106 @@
+
+#ifndef TWOQ_POLICY_C
+#define TWOQ_POLICY_C
+
+#include "MyDB_TwoQPolicy.h"
+
+using namespace std;
+
+MyDB_TwoQPolicy :: MyDB_TwoQPolicy (size_t maxFrames, size_t numFrames, size_t ringFrames) : 
+	MyDB_ReplacementPolicy (maxFrames, numFrames, ringFrames), which (maxFrames, nullptr), where (maxFrames), keys (maxFrames) {
+	resized ();
+}
+
+void MyDB_TwoQPolicy :: resized () {
+	lock_guard <mutex> guard (latch);
+
+	// these are the sizes suggested in the paper
+	kIn = numFrames / 4;
+	if (kIn == 0)
+		kIn = 1;
+	kOut = numFrames / 2;
+	while (out.size () > kOut) {
+		outPages.erase (out.back ());
+		out.pop_back ();
+	}
+}
+
+void MyDB_TwoQPolicy :: admitPage (size_t frame, size_t fileId, size_t pageNo) {
+	lock_guard <mutex> guard (latch);
+
+	// if we remember this guy, he goes right into the main list
+	size_t key = pageKey (fileId, pageNo);
+	auto found = outPages.find (key);
+	if (found != outPages.end ()) {
+		out.erase (found->second);
+		outPages.erase (found);
+		main.push_front (frame);
+		which[frame] = &main;
+	} else {
+		in.push_front (frame);
+		which[frame] = &in;
+	}
+
+	where[frame] = which[frame]->begin ();
+	keys[frame] = key;
+}
+
+void MyDB_TwoQPolicy :: touchPage (size_t frame) {
+	lock_guard <mutex> guard (latch);
+
+	// only the pages in the main list are kept in LRU order
+	if (which[frame] == &main)
+		main.splice (main.begin (), main, where[frame]);
+}
+
+void MyDB_TwoQPolicy :: removePage (size_t frame) {
+	lock_guard <mutex> guard (latch);
+	if (which[frame] != nullptr) {
+		which[frame]->erase (where[frame]);
+		which[frame] = nullptr;
+	}
+}
+
+long MyDB_TwoQPolicy :: claimFrom (list <size_t> &fromMe, function <bool (size_t)> &claim) {
+	for (auto it = fromMe.rbegin (); it != fromMe.rend (); it++) {
+		size_t frame = *it;
+		if (!claim (frame))
+			continue;
+
+		// pages kicked out of A1in are remembered in A1out
+		if (&fromMe == &in) {
+			out.push_front (keys[frame]);
+			outPages[keys[frame]] = out.begin ();
+			if (out.size () > kOut) {
+				outPages.erase (out.back ());
+				out.pop_back ();
+			}
+		}
+
+		fromMe.erase (where[frame]);
+		which[frame] = nullptr;
+		return frame;
+	}
+	return -1;
+}
+
+long MyDB_TwoQPolicy :: findPageVictim (function <bool (size_t)> &claim) {
+	lock_guard <mutex> guard (latch);
+
+	// take from A1in if it is over its target size, and from Am otherwise... if
+	// everything in that list is busy, try the other one
+	long victim;
+	if (in.size () > kIn) {
+		victim = claimFrom (in, claim);
+		if (victim == -1)
+			victim = claimFrom (main, claim);
+	} else {
+		victim = claimFrom (main, claim);
+		if (victim == -1)
+			victim = claimFrom (in, claim);
+	}
+	return victim;
+}
+
+#endif
+
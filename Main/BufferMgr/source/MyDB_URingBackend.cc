@@ -0,0 +1,201 @@
+
+#ifndef URING_BACKEND_C
+#define URING_BACKEND_C
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "MyDB_URingBackend.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std;
+
+MyDB_URingBackend :: MyDB_URingBackend () {
+	nextRing = 0;
+	for (int i = 0; i < NUM_RINGS; i++) {
+		unique_ptr <Ring> ring (new Ring);
+		if (!setUp (*ring))
+			break;
+		rings.push_back (move (ring));
+	}
+}
+
+MyDB_URingBackend :: ~MyDB_URingBackend () {
+	for (auto &ring : rings) {
+		munmap (ring->sqeMapping, ring->sqeMappingSize);
+		if (ring->cqMapping != ring->sqMapping)
+			munmap (ring->cqMapping, ring->cqMappingSize);
+		munmap (ring->sqMapping, ring->sqMappingSize);
+		close (ring->fd);
+	}
+}
+
+bool MyDB_URingBackend :: setUp (Ring &ring) {
+
+	struct io_uring_params params;
+	memset (&params, 0, sizeof (params));
+	ring.fd = syscall (__NR_io_uring_setup, RING_ENTRIES, &params);
+	if (ring.fd < 0)
+		return false;
+
+	// map in the queues; newer kernels put both of them in one mapping
+	ring.sqMappingSize = params.sq_off.array + params.sq_entries * sizeof (unsigned);
+	ring.cqMappingSize = params.cq_off.cqes + params.cq_entries * sizeof (struct io_uring_cqe);
+	bool singleMapping = params.features & IORING_FEAT_SINGLE_MMAP;
+	if (singleMapping && ring.cqMappingSize > ring.sqMappingSize)
+		ring.sqMappingSize = ring.cqMappingSize;
+
+	ring.sqMapping = mmap (nullptr, ring.sqMappingSize, PROT_READ | PROT_WRITE, 
+		MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQ_RING);
+	if (ring.sqMapping == MAP_FAILED) {
+		close (ring.fd);
+		return false;
+	}
+
+	ring.cqMapping = ring.sqMapping;
+	if (!singleMapping) {
+		ring.cqMapping = mmap (nullptr, ring.cqMappingSize, PROT_READ | PROT_WRITE, 
+			MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_CQ_RING);
+		if (ring.cqMapping == MAP_FAILED) {
+			munmap (ring.sqMapping, ring.sqMappingSize);
+			close (ring.fd);
+			return false;
+		}
+	}
+
+	ring.sqeMappingSize = params.sq_entries * sizeof (struct io_uring_sqe);
+	ring.sqeMapping = mmap (nullptr, ring.sqeMappingSize, PROT_READ | PROT_WRITE, 
+		MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES);
+	if (ring.sqeMapping == MAP_FAILED) {
+		if (ring.cqMapping != ring.sqMapping)
+			munmap (ring.cqMapping, ring.cqMappingSize);
+		munmap (ring.sqMapping, ring.sqMappingSize);
+		close (ring.fd);
+		return false;
+	}
+
+	// and find everything in them
+	char *sq = (char *) ring.sqMapping;
+	ring.sqHead = (unsigned *) (sq + params.sq_off.head);
+	ring.sqTail = (unsigned *) (sq + params.sq_off.tail);
+	ring.sqMask = (unsigned *) (sq + params.sq_off.ring_mask);
+	ring.sqArray = (unsigned *) (sq + params.sq_off.array);
+	ring.sqes = (struct io_uring_sqe *) ring.sqeMapping;
+
+	char *cq = (char *) ring.cqMapping;
+	ring.cqHead = (unsigned *) (cq + params.cq_off.head);
+	ring.cqTail = (unsigned *) (cq + params.cq_off.tail);
+	ring.cqMask = (unsigned *) (cq + params.cq_off.ring_mask);
+	ring.cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+	return true;
+}
+
+MyDB_URingBackend :: Ring &MyDB_URingBackend :: getRing () {
+
+	// take the first ring that is free, starting at a different one each time
+	size_t start = nextRing++;
+	for (size_t i = 0; i < rings.size (); i++) {
+		Ring &ring = *rings[(start + i) % rings.size ()];
+		if (ring.latch.try_lock ())
+			return ring;
+	}
+
+	// they are all busy, so wait for one
+	Ring &ring = *rings[start % rings.size ()];
+	ring.latch.lock ();
+	return ring;
+}
+
+void MyDB_URingBackend :: submit (Ring &ring, MyDB_IORequest *requests, size_t numRequests, bool isWrite) {
+
+	// fill in the submission queue entries... we are the only ones adding to the queue
+	unsigned tail = *ring.sqTail;
+	unsigned mask = *ring.sqMask;
+	for (size_t i = 0; i < numRequests; i++) {
+		unsigned index = tail & mask;
+		struct io_uring_sqe *entry = &ring.sqes[index];
+		memset (entry, 0, sizeof (*entry));
+		entry->opcode = isWrite ? IORING_OP_WRITEV : IORING_OP_READV;
+		entry->fd = requests[i].fd;
+		entry->addr = (unsigned long) requests[i].buffers;
+		entry->len = requests[i].numBuffers;
+		entry->off = requests[i].offset;
+		entry->user_data = i;
+		ring.sqArray[index] = index;
+		tail++;
+	}
+	__atomic_store_n (ring.sqTail, tail, __ATOMIC_RELEASE);
+
+	// submit them all and wait for them all, with (usually) one system call
+	size_t numFinished = 0;
+	size_t toSubmit = numRequests;
+	while (numFinished < numRequests) {
+		int submitted = syscall (__NR_io_uring_enter, ring.fd, toSubmit, numRequests - numFinished, 
+			IORING_ENTER_GETEVENTS, nullptr, 0);
+		if (submitted < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+			cout << "io_uring_enter failed: " << strerror (errno) << "\n";
+			exit (1);
+		}
+		if (submitted > 0)
+			toSubmit -= submitted;
+
+		// go through whatever has finished
+		unsigned head = *ring.cqHead;
+		while (head != __atomic_load_n (ring.cqTail, __ATOMIC_ACQUIRE)) {
+			struct io_uring_cqe *completion = &ring.cqes[head & *ring.cqMask];
+			MyDB_IORequest &request = requests[completion->user_data];
+
+			// a failed request, or a write that did not get everything out, is done
+			// over the old-fashioned way (a short read is just the end of the file)
+			if (completion->res < 0) {
+				if (isWrite)
+					pwritev (request.fd, request.buffers, request.numBuffers, request.offset);
+				else
+					preadv (request.fd, request.buffers, request.numBuffers, request.offset);
+			} else if (isWrite) {
+				size_t length = 0;
+				for (int i = 0; i < request.numBuffers; i++)
+					length += request.buffers[i].iov_len;
+				if ((size_t) completion->res < length)
+					pwritev (request.fd, request.buffers, request.numBuffers, request.offset);
+			}
+
+			numFinished++;
+			head++;
+		}
+		__atomic_store_n (ring.cqHead, head, __ATOMIC_RELEASE);
+	}
+}
+
+void MyDB_URingBackend :: read (MyDB_IORequest &request) {
+	if (rings.size () == 0) {
+		MyDB_PReadBackend :: read (request);
+		return;
+	}
+
+	Ring &ring = getRing ();
+	lock_guard <mutex> guard (ring.latch, adopt_lock);
+	submit (ring, &request, 1, false);
+}
+
+void MyDB_URingBackend :: write (vector <MyDB_IORequest> &requests) {
+	if (rings.size () == 0) {
+		MyDB_PReadBackend :: write (requests);
+		return;
+	}
+
+	for (size_t first = 0; first < requests.size (); first += RING_ENTRIES) {
+		Ring &ring = getRing ();
+		lock_guard <mutex> guard (ring.latch, adopt_lock);
+		submit (ring, &requests[first], min ((size_t) RING_ENTRIES, requests.size () - first), true);
+	}
+}
+
+MyDB_IOBackendType MyDB_URingBackend :: getType () {
+	return rings.size () == 0 ? PReadBackend : URingBackend;
+}
+
+#endif
@@ -5,15 +5,63 @@
 #include "MyDB_BufferManager.h"
 #include "MyDB_PageHandle.h"
 #include "MyDB_Table.h"
+#include "MyDB_TraceSimulator.h"
 #include "QUnit.h"
+#include <atomic>
+#include <chrono>
 #include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
 #include <iostream>
+#include <linux/perf_event.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
 #include <time.h>
 #include <unistd.h>
 #include <vector>
 
 using namespace std;
 
+// starts counting this thread's data TLB misses; returns the counter's fd, or -1
+// if the kernel does not let us count them
+int startTLBCounter () {
+	struct perf_event_attr attr;
+	memset (&attr, 0, sizeof (attr));
+	attr.type = PERF_TYPE_HW_CACHE;
+	attr.size = sizeof (attr);
+	attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+// stops the counter and returns the count
+long long stopTLBCounter (int fd) {
+	long long count = -1;
+	if (fd == -1 || read (fd, &count, sizeof (count)) != sizeof (count))
+		count = -1;
+	if (fd != -1)
+		close (fd);
+	return count;
+}
+
+// counts the heap allocations made by each thread
+thread_local size_t numAllocations = 0;
+
+void *operator new (size_t size) {
+	numAllocations++;
+	void *returnVal = malloc (size);
+	if (returnVal == nullptr)
+		throw bad_alloc ();
+	return returnVal;
+}
+
+void operator delete (void *deleteMe) noexcept {
+	free (deleteMe);
+}
+
 int main () {
 
 	//QUnit::UnitTest qunit(cerr, QUnit::verbose);
@@ -271,6 +319,1236 @@ int main () {
 	}
 	cout << "COMPLETE" << endl << flush;
 	QUNIT_IS_TRUE(flag9);
+
+	// pinned pages exhaust the pool
+	bool flag10 = true;
+	cout << "TEST 10..." << flush;
+	{
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		cout << "get page..." << flush;
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("table1", "file1");
+		vector<MyDB_PageHandle> pages(16);
+		for (int i = 0; i < 16; i++) {
+			pages[i] = myMgr.getPinnedPage(table1, i);
+			if (pages[i] == nullptr) flag10 = false;
+		}
+		cout << "pin one too many..." << flush;
+		if (myMgr.getPinnedPage(table1, 16) != nullptr) flag10 = false;
+		if (myMgr.getPinnedPage() != nullptr) flag10 = false;
+		cout << "release one..." << flush;
+		pages[3] = nullptr;
+		if (myMgr.getPinnedPage(table1, 16) == nullptr) flag10 = false;
+		if (flag10) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag10);
+
+	// many tables sharing a small pool, with table objects that alias the same file
+	bool flag11 = true;
+	cout << "TEST 11..." << flush;
+	{
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		vector<MyDB_TablePtr> tables;
+		for (int i = 0; i < 8; i++) {
+			tables.push_back(make_shared <MyDB_Table>("mtable" + to_string(i), "mfile" + to_string(i)));
+		}
+		cout << "write bytes..." << flush;
+		for (int j = 0; j < 40; j++) {
+			for (int i = 0; i < 8; i++) {
+				MyDB_PageHandle page = myMgr.getPage(tables[i], j);
+				char *bytes = (char *)page->getBytes();
+				memset(bytes, (char)('A' + (i * 40 + j) % 50), 64);
+				page->wroteBytes();
+			}
+		}
+		cout << "read bytes..." << flush;
+		for (int j = 39; j >= 0; j--) {
+			for (int i = 0; i < 8; i++) {
+				MyDB_TablePtr alias = make_shared <MyDB_Table>("mtable" + to_string(i), "mfile" + to_string(i));
+				MyDB_PageHandle page = myMgr.getPage(alias, j);
+				char *bytes = (char *)page->getBytes();
+				char c = (char)('A' + (i * 40 + j) % 50);
+				for (int k = 0; k < 64; k++) {
+					if (bytes[k] != c) flag11 = false;
+				}
+			}
+		}
+		if (flag11) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag11);
+
+	// many threads pinning, writing, and reading pages in a small pool
+	atomic<bool> flag12(true);
+	cout << "TEST 12..." << flush;
+	{
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		myMgr.setPinTimeout(5000);
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("stable1", "sfile1");
+		int numThreads = 8;
+		cout << "start threads..." << flush;
+		vector<thread> threads;
+		for (int t = 0; t < numThreads; t++) {
+			threads.push_back(thread([&myMgr, &flag12, table1, numThreads, t] {
+
+				// each thread owns every numThreads^th page, and rewrites each one several times
+				for (int round = 0; round < 10; round++) {
+					for (int j = t; j < 160; j += numThreads) {
+						MyDB_PageHandle page = myMgr.getPinnedPage(table1, j);
+						if (page == nullptr) {
+							flag12 = false;
+							continue;
+						}
+						char *bytes = (char *)page->getBytes();
+						if (round > 0 && bytes[j % 64] != (char)('A' + (j + round - 1) % 50)) flag12 = false;
+						memset(bytes, (char)('A' + (j + round) % 50), 64);
+						page->wroteBytes();
+
+						// and a temp page, which is written and read back while pinned
+						MyDB_PageHandle temp = myMgr.getPinnedPage();
+						if (temp == nullptr) {
+							flag12 = false;
+							continue;
+						}
+						char *tempBytes = (char *)temp->getBytes();
+						memset(tempBytes, (char)('a' + t), 64);
+						temp->wroteBytes();
+						if (tempBytes[63] != (char)('a' + t)) flag12 = false;
+
+						// and touch someone else's page without pinning it... the threads can have every
+						// frame pinned, in which case there is no room for it, and that is fine
+						MyDB_PageHandle other = myMgr.getPage(table1, (j + 1) % 160);
+						other->getBytes();
+					}
+				}
+			}));
+		}
+		for (auto &th : threads) {
+			th.join();
+		}
+		if (flag12) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag12);
+
+	// a pin request waits for another thread to let go of a page
+	bool flag13 = true;
+	cout << "TEST 13..." << flush;
+	{
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 2, "tempDSFSD");
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("table1", "file1");
+		MyDB_PageHandle page0 = myMgr.getPinnedPage(table1, 0);
+		MyDB_PageHandle page1 = myMgr.getPinnedPage(table1, 1);
+		cout << "time out..." << flush;
+		myMgr.setPinTimeout(50);
+		if (myMgr.getPinnedPage(table1, 2) != nullptr) flag13 = false;
+		cout << "wait..." << flush;
+		myMgr.setPinTimeout(5000);
+		thread releaser([&page1] {
+			this_thread::sleep_for(chrono::milliseconds(100));
+			page1 = nullptr;
+		});
+		if (myMgr.getPinnedPage(table1, 2) == nullptr) flag13 = false;
+		releaser.join();
+
+		// and when other threads have every frame pinned, reading an unpinned page fails
+		// (rather than taking everything down), until one of them lets go
+		cout << "pinned by others..." << flush;
+		page0 = nullptr;
+		page1 = nullptr;
+		myMgr.setPinTimeout(50);
+		atomic <int> numPinned(0);
+		atomic <bool> release(false);
+		vector<thread> pinners;
+		for (int t = 0; t < 2; t++) {
+			pinners.push_back(thread([&myMgr, &numPinned, &release, table1, t] {
+				MyDB_PageHandle mine = myMgr.getPinnedPage(table1, 4 + t);
+				numPinned++;
+				while (!release)
+					this_thread::sleep_for(chrono::milliseconds(1));
+			}));
+		}
+		while (numPinned < 2)
+			this_thread::sleep_for(chrono::milliseconds(1));
+		MyDB_PageHandle unpinned = myMgr.getPage(table1, 6);
+		if (unpinned->getBytes() != nullptr) flag13 = false;
+		release = true;
+		for (auto &th : pinners) {
+			th.join();
+		}
+		if (unpinned->getBytes() == nullptr) flag13 = false;
+		if (flag13) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag13);
+
+	// hit throughput from 1 to 8 threads
+	cout << "TEST 14..." << flush;
+	{
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 256, "tempDSFSD");
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("table1", "file1");
+		vector<MyDB_PageHandle> pages(256);
+		for (int i = 0; i < 256; i++) {
+			pages[i] = myMgr.getPage(table1, i);
+			pages[i]->getBytes();
+		}
+		for (int numThreads = 1; numThreads <= 8; numThreads *= 2) {
+			auto t1 = chrono::steady_clock::now();
+			vector<thread> threads;
+			for (int t = 0; t < numThreads; t++) {
+				threads.push_back(thread([&myMgr, table1, t] {
+					volatile char *bytes;
+					for (int i = 0; i < 20000; i++) {
+						MyDB_PageHandle page = myMgr.getPage(table1, (i * 7 + t) % 256);
+						bytes = (char *)page->getBytes();
+					}
+					(void) bytes;
+				}));
+			}
+			for (auto &th : threads) {
+				th.join();
+			}
+			auto t2 = chrono::steady_clock::now();
+			double secs = chrono::duration<double>(t2 - t1).count();
+			cout << numThreads << " threads: " << (long) (numThreads * 20000 / secs) << " hits/sec..." << flush;
+		}
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(true);
+
+	// reading ahead, both when a scan is noticed and when it is asked for
+	bool flag15 = true;
+	cout << "TEST 15..." << flush;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("rtable", "rfile");
+		table1->setLastPage(199);
+		{
+			cout << "create manager..." << flush;
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+			cout << "write bytes..." << flush;
+			for (int i = 0; i < 200; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table1, i);
+				char *bytes = (char *)page->getBytes();
+				memset(bytes, (char)('A' + i % 50), 64);
+				page->wroteBytes();
+			}
+			cout << "shutdown manager..." << flush;
+		}
+
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 32, "tempDSFSD");
+		cout << "scan..." << flush;
+		for (int i = 0; i < 200; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table1, i);
+			char *bytes = (char *)page->getBytes();
+			for (int k = 0; k < 64; k++) {
+				if (bytes[k] != (char)('A' + i % 50)) flag15 = false;
+			}
+		}
+
+		// the pages that are read ahead may not push out a page that someone has a handle to
+		cout << "prefetch..." << flush;
+		MyDB_PageHandle held = myMgr.getPage(table1, 0);
+		char *heldBytes = (char *)held->getBytes();
+		myMgr.prefetch(table1, 100, 100);
+		myMgr.adviseAccess(table1, WillNeedAccess);
+		usleep(100000);
+		for (int k = 0; k < 64; k++) {
+			if (heldBytes[k] != 'A') flag15 = false;
+		}
+		myMgr.adviseAccess(table1, RandomAccess);
+		for (int i = 199; i >= 0; i -= 3) {
+			MyDB_PageHandle page = myMgr.getPage(table1, i);
+			char *bytes = (char *)page->getBytes();
+			for (int k = 0; k < 64; k++) {
+				if (bytes[k] != (char)('A' + i % 50)) flag15 = false;
+			}
+		}
+		if (flag15) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag15);
+
+	// replacement policies, on a hot set of pages that keeps getting pushed out by scans
+	bool flag16 = true;
+	cout << "TEST 16..." << flush;
+	{
+		MyDB_TablePtr hotTable = make_shared <MyDB_Table>("hottable", "hotfile");
+		MyDB_TablePtr coldTable = make_shared <MyDB_Table>("coldtable", "coldfile");
+		coldTable->setLastPage(239);
+		{
+			cout << "create manager..." << flush;
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+			cout << "write bytes..." << flush;
+			for (int i = 0; i < 240; i++) {
+				MyDB_PageHandle page = myMgr.getPage(coldTable, i);
+				memset(page->getBytes(), (char)('A' + i % 50), 64);
+				page->wroteBytes();
+				if (i < 16) {
+					page = myMgr.getPage(hotTable, i);
+					memset(page->getBytes(), (char)('A' + i % 50), 64);
+					page->wroteBytes();
+				}
+			}
+			cout << "shutdown manager..." << flush;
+		}
+
+		// each round uses the hot pages three times, then scans some cold pages
+		auto runWorkload = [&](MyDB_ReplacementType replacement, bool useRing) {
+			MyDB_BufferManager myMgr(64, 32, "tempDSFSD", replacement);
+			if (!useRing) {
+				myMgr.adviseAccess(hotTable, RandomAccess);
+				myMgr.adviseAccess(coldTable, RandomAccess);
+			}
+			for (int round = 0; round < 10; round++) {
+				for (int pass = 0; pass < 3; pass++) {
+					for (int i = 0; i < 16; i++) {
+						MyDB_PageHandle page = myMgr.getPage(hotTable, i);
+						if (((char *)page->getBytes())[0] != (char)('A' + i % 50)) flag16 = false;
+					}
+				}
+				for (int i = round * 24; i < round * 24 + 24; i++) {
+					MyDB_PageHandle page = myMgr.getPage(coldTable, i);
+					if (((char *)page->getBytes())[63] != (char)('A' + i % 50)) flag16 = false;
+				}
+			}
+			return myMgr.getNumReads();
+		};
+
+		cout << "run workloads..." << flush;
+		size_t lru = runWorkload(LRUReplacement, false);
+		size_t clock = runWorkload(ClockReplacement, false);
+		size_t lruK = runWorkload(LRUKReplacement, false);
+		size_t twoQ = runWorkload(TwoQReplacement, false);
+		size_t arc = runWorkload(ARCReplacement, false);
+		size_t ring = runWorkload(LRUReplacement, true);
+		cout << "pages read (of 720 hot and 240 cold accesses): LRU " << lru << ", CLOCK " << clock 
+			<< ", LRU-2 " << lruK << ", 2Q " << twoQ << ", ARC " << arc << ", LRU with scan ring " << ring << "..." << flush;
+		if (!(lruK < lru && arc < lru && twoQ < lru && ring < lru)) flag16 = false;
+		if (flag16) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag16);
+
+	// the frame arena, with and without huge pages
+	bool flag17 = true;
+	cout << "TEST 17..." << flush;
+	{
+		const char *names[] = {"regular", "transparent huge", "explicit huge"};
+		for (int mode = 0; mode < 3; mode++) {
+			for (int prefault = 0; prefault < 2; prefault++) {
+				MyDB_BufferOptions options;
+				options.hugePages = (MyDB_HugePages) mode;
+				options.prefault = prefault;
+				MyDB_BufferManager myMgr(4096, 8192, "tempDSFSD", options);
+				cout << names[mode] << (prefault ? " prefaulted" : "") << " pages (got " 
+					<< names[myMgr.getArena().getHugePages()] << "): setup " 
+					<< (long) (myMgr.getArena().getSetupTime() * 1000000) << "us, " << flush;
+
+				// fill every frame, checking that each one is aligned
+				vector<MyDB_PageHandle> pages;
+				for (int i = 0; i < 8192; i++) {
+					pages.push_back(myMgr.getPinnedPage());
+					char *bytes = (char *)pages[i]->getBytes();
+					if ((size_t) bytes % 4096 != 0) flag17 = false;
+					bytes[0] = (char) i;
+				}
+
+				// then bounce around all over the pool
+				vector<char *> allBytes;
+				for (auto &page : pages) {
+					allBytes.push_back((char *)page->getBytes());
+				}
+				int counter = startTLBCounter();
+				auto t1 = chrono::steady_clock::now();
+				size_t where = 0;
+				volatile long sum = 0;
+				for (int i = 0; i < 4000000; i++) {
+					where = (where * 1103515245 + 12345) % 8192;
+					sum += allBytes[where][(i * 64) % 4096];
+				}
+				auto t2 = chrono::steady_clock::now();
+				long long misses = stopTLBCounter(counter);
+				cout << (long) (chrono::duration<double>(t2 - t1).count() * 1000000000 / 4000000) << "ns/access, ";
+				if (misses >= 0) cout << misses << " dTLB misses..." << flush;
+				else cout << "dTLB misses not available..." << flush;
+
+				for (int i = 0; i < 8192; i++) {
+					if (((char *)pages[i]->getBytes())[0] != (char) i) flag17 = false;
+				}
+			}
+		}
+		if (flag17) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag17);
+
+	// direct I/O
+	bool flag18 = true;
+	cout << "TEST 18..." << flush;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("dtable", "dfile");
+		MyDB_BufferOptions options;
+		options.directIO = true;
+		for (int round = 0; round < 2; round++) {
+			cout << "create manager..." << flush;
+			MyDB_BufferManager myMgr(4096, 16, "tempDSFSD", options);
+			cout << (myMgr.usesDirectIO(table1) ? "direct..." : "not direct...") << flush;
+			for (int i = 0; i < 64; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table1, i);
+				char *bytes = (char *)page->getBytes();
+				for (int k = 0; k < 4096; k++) {
+					if (round == 0) bytes[k] = (char)(i + k);
+					else if (bytes[k] != (char)(i + k)) flag18 = false;
+				}
+				if (round == 0) page->wroteBytes();
+			}
+			cout << "shutdown manager..." << flush;
+		}
+
+		// a page size that does not line up means no direct I/O
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD", options);
+		if (myMgr.usesDirectIO(table1)) flag18 = false;
+		if (flag18) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag18);
+
+	// the background cleaner, and flushing
+	bool flag19 = true;
+	cout << "TEST 19..." << flush;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("ctable", "cfile");
+		for (int clean = 0; clean < 2; clean++) {
+			MyDB_BufferOptions options;
+			options.cleanFrames = clean ? 16 : 0;
+			auto t1 = chrono::steady_clock::now();
+			{
+				MyDB_BufferManager myMgr(4096, 64, "tempDSFSD", options);
+
+				// append a lot of pages, so that most of them are written back before the end
+				for (int i = 0; i < 2048; i++) {
+					MyDB_PageHandle page = myMgr.getPage(table1, i);
+					char *bytes = (char *)page->getBytes();
+					for (int k = 0; k < 4096; k += 64) {
+						bytes[k] = (char)(i + k + clean);
+					}
+					page->wroteBytes();
+				}
+
+				// the last few pages are only in RAM until they are flushed
+				myMgr.flush();
+				int fd = open("cfile", O_RDONLY);
+				char bytes[4096];
+				for (int i = 2048 - 32; i < 2048; i++) {
+					if (pread(fd, bytes, 4096, i * 4096) != 4096 || bytes[64] != (char)(i + 64 + clean)) flag19 = false;
+				}
+				close(fd);
+			}
+			auto t2 = chrono::steady_clock::now();
+			cout << (clean ? "with" : "without") << " cleaner " 
+				<< (long) (chrono::duration<double>(t2 - t1).count() * 1000) << "ms..." << flush;
+
+			// and check everything
+			MyDB_BufferManager myMgr(4096, 64, "tempDSFSD");
+			for (int i = 0; i < 2048; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table1, i);
+				char *bytes = (char *)page->getBytes();
+				for (int k = 0; k < 4096; k += 64) {
+					if (bytes[k] != (char)(i + k + clean)) flag19 = false;
+				}
+			}
+		}
+		if (flag19) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag19);
+
+	// the I/O backends, and how long a miss takes with each of them
+	bool flag20 = true;
+	cout << "TEST 20..." << flush;
+	{
+		const char *names[] = {"pread", "io_uring", "mmap"};
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("iotable", "iofile");
+		for (int backend = 0; backend < 3; backend++) {
+			MyDB_BufferOptions options;
+			options.ioBackend = (MyDB_IOBackendType) backend;
+
+			// write the table with this backend (writing back 16 pages at a time)...
+			{
+				MyDB_BufferManager myMgr(4096, 64, "tempDSFSD", options);
+				cout << names[backend] << " (got " << names[myMgr.getIOBackend().getType()] << "): " << flush;
+				for (int i = 0; i < 1024; i++) {
+					MyDB_PageHandle page = myMgr.getPage(table1, i);
+					char *bytes = (char *)page->getBytes();
+					for (int k = 0; k < 4096; k += 64) {
+						bytes[k] = (char)(i + k + backend);
+					}
+					page->wroteBytes();
+					if (i % 16 == 15) myMgr.flush();
+				}
+			}
+
+			// ...then read it back all over the place with a tiny buffer, so almost every access is a miss
+			MyDB_BufferManager myMgr(4096, 16, "tempDSFSD", options);
+			myMgr.adviseAccess(table1, RandomAccess);
+			size_t where = 0;
+			auto t1 = chrono::steady_clock::now();
+			for (int i = 0; i < 8192; i++) {
+				where = (where * 1103515245 + 12345) % 1024;
+				MyDB_PageHandle page = myMgr.getPage(table1, where);
+				char *bytes = (char *)page->getBytes();
+				if (bytes[64 * (i % 64)] != (char)(where + 64 * (i % 64) + backend)) flag20 = false;
+			}
+			auto t2 = chrono::steady_clock::now();
+			cout << (long) (chrono::duration<double>(t2 - t1).count() * 1000000000 / myMgr.getNumReads()) 
+				<< "ns/miss (" << myMgr.getNumReads() << " misses)..." << flush;
+		}
+		if (flag20) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag20);
+
+	// the stats
+	bool flag21 = true;
+	cout << "TEST 21..." << flush;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("stable1", "sfile1");
+		MyDB_TablePtr table2 = make_shared <MyDB_Table>("stable2", "sfile2");
+		MyDB_BufferOptions options;
+		options.trackLatency = true;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD", options);
+		myMgr.adviseAccess(table1, RandomAccess);
+		myMgr.adviseAccess(table2, RandomAccess);
+
+		// 4 misses and then 12 hits on table1, and 32 misses on table2, which kick pages out
+		for (int i = 0; i < 16; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table1, i % 4);
+			char *bytes = (char *)page->getBytes();
+			bytes[0] = 'a';
+			page->wroteBytes();
+		}
+		for (int i = 0; i < 32; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table2, i);
+			page->getBytes();
+		}
+
+		// pin every frame, so that one more pinned page fails
+		vector<MyDB_PageHandle> pinned;
+		for (int i = 0; i < 16; i++) {
+			pinned.push_back(myMgr.getPinnedPage());
+		}
+		if (myMgr.getPinnedPage() != nullptr) flag21 = false;
+		pinned.clear();
+
+		// letting go of the pinned anonymous pages empties the temp file again
+		MyDB_BufferStats stats = myMgr.getStats();
+		cout << "hits " << stats.hits << ", misses " << stats.misses << ", evictions " << stats.evictions 
+			<< ", write-backs " << stats.dirtyWriteBacks << "..." << flush;
+		if (stats.hits != 12 || stats.misses != 36 || stats.pinFailures != 1 || stats.tempPages != 0) flag21 = false;
+		if (stats.dirtyWriteBacks != 4 || stats.bytesWritten != 4 * 64 || stats.evictions < 32) flag21 = false;
+		for (auto &table : stats.tables) {
+			if (table.table == "stable1" && (table.hits != 12 || table.misses != 4)) flag21 = false;
+			if (table.table == "stable2" && (table.hits != 0 || table.misses != 32)) flag21 = false;
+		}
+		if (stats.readLatency.count != 36 || stats.writeLatency.count == 0) flag21 = false;
+		if (stats.hitRate() != 12.0 / 48) flag21 = false;
+
+		// and make sure that the dump has the interesting lines
+		stringstream dump;
+		stats.dump(dump);
+		if (dump.str().find("mydb_buffer_hits_total 12\n") == string::npos) flag21 = false;
+		if (dump.str().find("mydb_buffer_table_misses_total{table=\"stable2\"} 32\n") == string::npos) flag21 = false;
+		if (dump.str().find("mydb_buffer_read_latency_microseconds_count 36\n") == string::npos) flag21 = false;
+		if (flag21) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag21);
+
+	// growing and shrinking the buffer while it is in use
+	bool flag22 = true;
+	cout << "TEST 22..." << flush;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("gtable", "gfile");
+		MyDB_BufferOptions options;
+		options.maxPages = 32;
+		MyDB_BufferManager myMgr(64, 8, "tempDSFSD", options);
+
+		// fill the buffer with pinned pages, and then make room for more
+		vector<MyDB_PageHandle> pinned;
+		for (int i = 0; i < 8; i++) {
+			pinned.push_back(myMgr.getPinnedPage(table1, i));
+			char *bytes = (char *)pinned[i]->getBytes();
+			memset(bytes, 'a' + i, 64);
+			pinned[i]->wroteBytes();
+		}
+		if (myMgr.getPinnedPage(table1, 8) != nullptr) flag22 = false;
+		cout << "grow..." << flush;
+		if (!myMgr.grow(8) || myMgr.getNumPages() != 16) flag22 = false;
+		for (int i = 8; i < 16; i++) {
+			pinned.push_back(myMgr.getPinnedPage(table1, i));
+			if (pinned[i] == nullptr) {
+				flag22 = false;
+				break;
+			}
+			char *bytes = (char *)pinned[i]->getBytes();
+			memset(bytes, 'a' + i, 64);
+			pinned[i]->wroteBytes();
+		}
+
+		// with everything pinned, the buffer cannot shrink; once half of the pages are let
+		// go of, it can shrink by that much (writing them back), but no more
+		cout << "shrink..." << flush;
+		if (flag22 && (myMgr.shrink(4) || myMgr.getNumPages() != 16)) flag22 = false;
+		pinned.resize(8);
+		if (myMgr.shrink(12) || !myMgr.shrink(8) || myMgr.getNumPages() != 8) flag22 = false;
+		if (myMgr.shrink(8) || myMgr.grow(25) || !myMgr.grow(24) || myMgr.getNumPages() != 32) flag22 = false;
+		pinned.clear();
+		if (!myMgr.shrink(24)) flag22 = false;
+		for (int i = 0; i < 16; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table1, i);
+			if (((char *)page->getBytes())[63] != 'a' + i) flag22 = false;
+		}
+
+		// and have some threads use the buffer while it keeps changing size (they pin the
+		// pages, since the bytes of an unpinned page can go away at any time)... frames can
+		// be busy for a moment while pages are read ahead or the buffer shrinks, so they wait
+		cout << "resize while in use..." << flush;
+		myMgr.setPinTimeout(1000);
+		atomic<bool> ok(true);
+		atomic<bool> done(false);
+		vector<thread> workers;
+		for (int t = 0; t < 4; t++) {
+			workers.push_back(thread([&, t] {
+				size_t where = t;
+				for (int i = 0; i < 4000; i++) {
+					where = (where * 1103515245 + 12345) % 16;
+					MyDB_PageHandle page = myMgr.getPinnedPage(table1, where);
+					if (page == nullptr || ((char *)page->getBytes())[63] != (char) ('a' + where)) ok = false;
+				}
+			}));
+		}
+		thread resizer([&] {
+			while (!done) {
+				myMgr.grow(8);
+				myMgr.shrink(8);
+			}
+		});
+		for (auto &worker : workers) {
+			worker.join();
+		}
+		done = true;
+		resizer.join();
+		if (!ok) flag22 = false;
+		if (flag22) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag22);
+
+	// tables (and anonymous pages) with pages of different sizes sharing the buffer
+	bool flag23 = true;
+	cout << "TEST 23..." << flush;
+	{
+		MyDB_TablePtr narrow = make_shared <MyDB_Table>("ntable", "nfile");
+		MyDB_TablePtr wide = make_shared <MyDB_Table>("wtable", "wfile");
+		wide->setPageSize(256);
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		myMgr.adviseAccess(narrow, RandomAccess);
+		myMgr.adviseAccess(wide, RandomAccess);
+		if (myMgr.getPageSize(narrow) != 64 || myMgr.getPageSize(wide) != 256) flag23 = false;
+
+		// write more of both kinds of pages than fit, so that each kind kicks out the other
+		cout << "write..." << flush;
+		for (int i = 0; i < 24; i++) {
+			MyDB_PageHandle page = myMgr.getPage(narrow, i);
+			memset(page->getBytes(), 'a' + i, 64);
+			page->wroteBytes();
+			page = myMgr.getPage(wide, i);
+			memset(page->getBytes(), 'A' + i, 256);
+			page->wroteBytes();
+		}
+		cout << "read..." << flush;
+		for (int i = 0; i < 24; i++) {
+			MyDB_PageHandle page = myMgr.getPage(wide, i);
+			char *bytes = (char *)page->getBytes();
+			if (bytes[0] != 'A' + i || bytes[255] != 'A' + i) flag23 = false;
+			page = myMgr.getPage(narrow, i);
+			bytes = (char *)page->getBytes();
+			if (bytes[0] != 'a' + i || bytes[63] != 'a' + i) flag23 = false;
+		}
+
+		// four pinned wide pages fill the buffer; anonymous pages can be bigger, too
+		cout << "pin..." << flush;
+		vector<MyDB_PageHandle> pinned;
+		for (int i = 0; i < 4; i++) {
+			pinned.push_back(myMgr.getPinnedPage(wide, i));
+			if (pinned[i] == nullptr) flag23 = false;
+		}
+		if (myMgr.getPinnedPage() != nullptr) flag23 = false;
+		pinned.pop_back();
+		pinned.push_back(myMgr.getPinnedPage(128));
+		pinned.push_back(myMgr.getPinnedPage(128));
+		if (pinned[3] == nullptr || pinned[4] == nullptr || myMgr.getPinnedPage(128) != nullptr) flag23 = false;
+		pinned.clear();
+		MyDB_PageHandle temp = myMgr.getPage(128);
+		memset(temp->getBytes(), 'z', 128);
+		temp->wroteBytes();
+		for (int i = 0; i < 16; i++) {
+			myMgr.getPage(narrow, i)->getBytes();
+		}
+		if (((char *)temp->getBytes())[127] != 'z') flag23 = false;
+
+		// the anonymous pages that were let go gave their space back, so only the one
+		// bigger page that is left is in a temp file
+		MyDB_BufferStats stats = myMgr.getStats();
+		if (stats.tempPages != 2) flag23 = false;
+		for (auto &table : stats.tables) {
+			if (table.table == "wtable" && stats.bytesRead < table.misses * 256) flag23 = false;
+		}
+
+		// and have some threads pin pages of both sizes at once
+		cout << "mixed threads..." << flush;
+		atomic<bool> ok(true);
+		vector<thread> workers;
+		for (int t = 0; t < 4; t++) {
+			workers.push_back(thread([&, t] {
+				size_t where = t;
+				for (int i = 0; i < 2000; i++) {
+					where = (where * 1103515245 + 12345) % 24;
+					bool isWide = (i + t) % 3 == 0;
+					MyDB_PageHandle page = myMgr.getPinnedPage(isWide ? wide : narrow, where);
+					if (page == nullptr) continue;
+					char *bytes = (char *)page->getBytes();
+					if (bytes[isWide ? 255 : 63] != (char) ((isWide ? 'A' : 'a') + where)) ok = false;
+				}
+			}));
+		}
+		for (auto &worker : workers) {
+			worker.join();
+		}
+		if (!ok) flag23 = false;
+		if (flag23) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag23);
+
+	// temp files giving back their space, and temp pages spread over spill directories
+	bool flag24 = true;
+	cout << "TEST 24..." << flush;
+	{
+		auto fileSize = [](string name) -> long {
+			struct stat info;
+			return stat(name.c_str(), &info) == 0 ? info.st_size : -1;
+		};
+
+		// the first four temp pages are written out to make room for the rest
+		{
+			MyDB_BufferManager myMgr(64, 4, "tempReclaim");
+			vector<MyDB_PageHandle> temps;
+			for (int i = 0; i < 8; i++) {
+				temps.push_back(myMgr.getPage());
+				memset(temps[i]->getBytes(), 'a' + i, 64);
+				temps[i]->wroteBytes();
+			}
+			cout << "spill..." << flush;
+			if (fileSize("tempReclaim") != 4 * 64) flag24 = false;
+
+			// letting go of all but the first one cuts the file back to one page, and then to nothing
+			cout << "reclaim..." << flush;
+			temps.resize(1);
+			if (fileSize("tempReclaim") != 64 || myMgr.getStats().tempPages != 1) flag24 = false;
+			if (((char *)temps[0]->getBytes())[63] != 'a') flag24 = false;
+			temps.clear();
+			if (fileSize("tempReclaim") != 0 || myMgr.getStats().tempPages != 0) flag24 = false;
+		}
+
+		// and with two spill directories, each way of placing the pages
+		cout << "spill directories..." << flush;
+		mkdir("spillA", 0777);
+		mkdir("spillB", 0777);
+		for (int placement = 0; placement < 2; placement++) {
+			{
+				MyDB_BufferOptions options;
+				options.spillDirs = {"spillA", "spillB"};
+				options.spillPlacement = placement == 0 ? RoundRobinSpill : FreeSpaceSpill;
+				MyDB_BufferManager myMgr(64, 4, "tempSpill", options);
+				vector<MyDB_PageHandle> temps;
+				for (int i = 0; i < 16; i++) {
+					temps.push_back(myMgr.getPage());
+					memset(temps[i]->getBytes(), 'a' + i, 64);
+					temps[i]->wroteBytes();
+				}
+				for (int i = 0; i < 16; i++) {
+					if (((char *)temps[i]->getBytes())[63] != 'a' + i) flag24 = false;
+				}
+
+				// every page has been written out by now; round robin puts half of them in each directory
+				long sizeA = fileSize("spillA/tempSpill");
+				long sizeB = fileSize("spillB/tempSpill");
+				if (sizeA + sizeB != 16 * 64 || (placement == 0 && sizeA != sizeB)) flag24 = false;
+				temps.clear();
+				if (fileSize("spillA/tempSpill") != 0 || fileSize("spillB/tempSpill") != 0) flag24 = false;
+			}
+			if (fileSize("spillA/tempSpill") != -1 || fileSize("spillB/tempSpill") != -1) flag24 = false;
+		}
+		rmdir("spillA");
+		rmdir("spillB");
+		if (flag24) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag24);
+
+	// page handles are values, and getting one for a buffered page does not touch the heap
+	bool flag25 = true;
+	cout << "TEST 25..." << flush;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("htable1", "hfile1");
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		for (int i = 0; i < 8; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table1, i);
+			memset(page->getBytes(), 'a' + i, 64);
+			page->wroteBytes();
+		}
+
+		// get, copy, move, and use handles to the buffered pages
+		cout << "hits..." << flush;
+		size_t before = numAllocations;
+		for (int i = 0; i < 10000; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table1, i % 8);
+			MyDB_PageHandle copy = page;
+			MyDB_PageHandle moved = std::move(page);
+			if (page != nullptr || ((char *)copy->getBytes())[63] != 'a' + i % 8) flag25 = false;
+			if (((char *)moved->getBytes())[0] != 'a' + i % 8) flag25 = false;
+		}
+		cout << numAllocations - before << " allocations..." << flush;
+		if (numAllocations != before) flag25 = false;
+
+		// a pinned page stays pinned until the last copy of its handle goes away
+		cout << "pins..." << flush;
+		MyDB_PageHandle pinned = myMgr.getPinnedPage(table1, 0);
+		MyDB_PageHandle copy = pinned;
+		pinned = nullptr;
+		vector<MyDB_PageHandle> others;
+		for (int i = 1; i < 16; i++) {
+			others.push_back(myMgr.getPinnedPage(table1, i));
+		}
+		if (others.back() == nullptr || myMgr.getPinnedPage(table1, 16) != nullptr) flag25 = false;
+		copy = nullptr;
+		MyDB_PageHandle last = myMgr.getPinnedPage(table1, 16);
+		if (last == nullptr) flag25 = false;
+		if (flag25) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag25);
+
+	// pinning a range of pages at once
+	bool flag26 = true;
+	cout << "TEST 26..." << flush;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("rtable1", "rfile1");
+		{
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+			for (int i = 0; i < 12; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table1, i);
+				memset(page->getBytes(), 'a' + i, 64);
+				page->wroteBytes();
+			}
+		}
+
+		MyDB_BufferOptions options;
+		options.trackLatency = true;
+		{
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD", options);
+			myMgr.adviseAccess(table1, RandomAccess);
+			myMgr.getPage(table1, 3)->getBytes();
+
+			// the pages on either side of the buffered one are read with one request each
+			cout << "pin..." << flush;
+			size_t readsBefore = myMgr.getStats().readLatency.count;
+			MyDB_PageRangePtr range = myMgr.pinRange(table1, 0, 12);
+			if (range == nullptr || range->getNumPages() != 12 || range->getNumBytes() != 12 * 64) {
+				flag26 = false;
+			} else {
+				if (myMgr.getStats().readLatency.count != readsBefore + 2) flag26 = false;
+				for (int i = 0; i < 12 * 64; i++) {
+					if ((*range)[i] != 'a' + i / 64) flag26 = false;
+				}
+
+				// copies in and out of the range can cross pages
+				char bytes[8];
+				range->copyOut(60, bytes, 8);
+				if (memcmp(bytes, "aaaabbbb", 8) != 0) flag26 = false;
+				range->copyIn(126, "zzzz", 4);
+			}
+
+			// there are only four frames left, so a range of eight fails... and leaves
+			// the four frames free
+			cout << "all or nothing..." << flush;
+			if (myMgr.pinRange(table1, 20, 8) != nullptr || myMgr.pinRange(table1, 0, 17) != nullptr) flag26 = false;
+			vector<MyDB_PageHandle> pinned;
+			for (int i = 0; i < 4; i++) {
+				pinned.push_back(myMgr.getPinnedPage(table1, 20 + i));
+			}
+			if (pinned.back() == nullptr || myMgr.getStats().pinFailures != 2) flag26 = false;
+
+			// and once the range goes away, its pages are not pinned any more
+			range = nullptr;
+			pinned.clear();
+			range = myMgr.pinRange(table1, 20, 16);
+			if (range == nullptr) flag26 = false;
+		}
+
+		// the bytes copied into the range were written back
+		{
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+			MyDB_PageHandle page1 = myMgr.getPage(table1, 1);
+			MyDB_PageHandle page2 = myMgr.getPage(table1, 2);
+			char *bytes1 = (char *)page1->getBytes();
+			char *bytes2 = (char *)page2->getBytes();
+			if (bytes1[61] != 'b' || bytes1[62] != 'z' || bytes1[63] != 'z') flag26 = false;
+			if (bytes2[0] != 'z' || bytes2[1] != 'z' || bytes2[2] != 'c') flag26 = false;
+		}
+		if (flag26) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag26);
+
+	// setting frames aside with memory grants
+	bool flag27 = true;
+	cout << "TEST 27..." << flush;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("rtable1", "rfile1");
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		if (myMgr.reserve(17) != nullptr || myMgr.reserve(0) != nullptr) flag27 = false;
+		MyDB_MemoryGrantPtr grant = myMgr.reserve(10);
+		if (grant == nullptr || grant->getNumFrames() != 10 || myMgr.getReservableFrames() != 6) flag27 = false;
+
+		// other pins only get the six frames that are not set aside, though the rest are free
+		cout << "others..." << flush;
+		vector<MyDB_PageHandle> pinned;
+		for (int i = 0; i < 6; i++) {
+			pinned.push_back(myMgr.getPinnedPage(table1, i));
+			if (pinned.back() == nullptr) flag27 = false;
+		}
+		if (myMgr.getPinnedPage(table1, 6) != nullptr || myMgr.getPinnedPage() != nullptr) flag27 = false;
+		if (myMgr.pinRange(table1, 6, 2) != nullptr || myMgr.getStats().pinFailures != 3) flag27 = false;
+
+		// while pins through the grant get its ten frames, and no more
+		cout << "grant..." << flush;
+		vector<MyDB_PageHandle> granted;
+		for (int i = 0; i < 8; i++) {
+			granted.push_back(grant->getPinnedPage(table1, 10 + i));
+			if (granted.back() == nullptr) flag27 = false;
+		}
+		granted.push_back(grant->getPinnedPage());
+		MyDB_PageRangePtr range = grant->pinRange(table1, 30, 1);
+		if (granted.back() == nullptr || range == nullptr || grant->getNumPinned() != 10) flag27 = false;
+		if (grant->getPinnedPage(table1, 40) != nullptr || grant->pinRange(table1, 40, 1) != nullptr) flag27 = false;
+
+		// pinning a page that is already pinned takes no more room
+		if (grant->getPinnedPage(table1, 10) == nullptr || grant->getNumPinned() != 10) flag27 = false;
+		if (myMgr.reserve(1) != nullptr || myMgr.getReservableFrames() != 0 || myMgr.shrink(1)) flag27 = false;
+
+		// un-pinning gives the room back
+		cout << "release..." << flush;
+		pinned.pop_back();
+		range = nullptr;
+		if (myMgr.getReservableFrames() != 1 || grant->getNumPinned() != 9) flag27 = false;
+
+		// and when the grant goes away, its frames go back to everyone, except for the ones
+		// holding pages still pinned through it
+		MyDB_PageHandle kept = granted[0];
+		granted.clear();
+		grant = nullptr;
+		if (myMgr.getReservableFrames() != 10) flag27 = false;
+		kept = nullptr;
+		if (myMgr.getReservableFrames() != 11) flag27 = false;
+		for (int i = 6; i < 18; i++) {
+			pinned.push_back(myMgr.getPinnedPage(table1, i));
+		}
+		if (pinned.back() != nullptr || pinned[pinned.size() - 2] == nullptr) flag27 = false;
+		if (flag27) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag27);
+
+	// recording page accesses, and playing them back
+	bool flag28 = true;
+	cout << "TEST 28..." << flush;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("rtable1", "rfile1");
+		MyDB_BufferOptions options;
+		options.replacement = LRUReplacement;
+		options.traceFile = "traceDSFSD";
+		size_t misses;
+		{
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD", options);
+			myMgr.adviseAccess(table1, RandomAccess);
+			MyDB_PageHandle pinned = myMgr.getPinnedPage(table1, 45);
+			unsigned next = 28;
+			for (int i = 0; i < 500; i++) {
+				next = next * 1103515245 + 12345;
+				MyDB_PageHandle page = myMgr.getPage(table1, (next >> 16) % 40);
+				page->getBytes();
+				if (i % 7 == 0) page->wroteBytes();
+			}
+			misses = myMgr.getStats().misses;
+		}
+
+		// the same policy with the same number of frames misses just as often as the buffer did
+		cout << "replay..." << flush;
+		size_t pageSize;
+		vector<MyDB_TraceEntry> entries;
+		if (!MyDB_AccessTrace::read("traceDSFSD", pageSize, entries) || pageSize != 64) flag28 = false;
+		MyDB_TraceSimulator simulator(entries);
+		if (simulator.getNumAccesses() != 501 || simulator.getNumPages() != 41) flag28 = false;
+		if (simulator.simulate(LRUReplacement, 16) != misses) flag28 = false;
+
+		// nothing beats Belady's algorithm, and with a frame for every page, each page misses once
+		size_t optimal = simulator.simulateOptimal(16);
+		for (MyDB_ReplacementType type : {ClockReplacement, LRUReplacement, LRUKReplacement, TwoQReplacement, ARCReplacement}) {
+			if (simulator.simulate(type, 16) < optimal) flag28 = false;
+			if (simulator.simulate(type, 41) != 41) flag28 = false;
+		}
+		if (optimal >= misses || simulator.simulateOptimal(41) != 41) flag28 = false;
+		unlink("traceDSFSD");
+		if (flag28) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag28);
+
+	// warming a new buffer up with the pages that the last one had
+	bool flag29 = true;
+	cout << "TEST 29..." << flush;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("rtable1", "rfile1");
+		MyDB_BufferOptions options;
+		options.replacement = LRUReplacement;
+		options.residentFile = "warmDSFSD";
+		{
+			// pages 4 through 7 end up the hottest
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD", options);
+			myMgr.adviseAccess(table1, RandomAccess);
+			for (int i = 0; i < 12; i++) {
+				myMgr.getPage(table1, i)->getBytes();
+			}
+			for (int i = 4; i < 8; i++) {
+				myMgr.getPage(table1, i)->getBytes();
+			}
+		}
+
+		// a buffer with room for four pages reads in just the hottest ones, in the background
+		cout << "prewarm..." << flush;
+		options.prewarm = true;
+		{
+			MyDB_BufferManager myMgr(64, 4, "tempDSFSD", options);
+			for (int i = 0; i < 1000 && myMgr.getNumReads() < 4; i++) {
+				this_thread::sleep_for(chrono::milliseconds(1));
+			}
+			MyDB_TablePtr sameTable = make_shared <MyDB_Table>("rtable1", "rfile1");
+			for (int i = 4; i < 8; i++) {
+				myMgr.getPage(sameTable, i)->getBytes();
+			}
+			MyDB_BufferStats stats = myMgr.getStats();
+			if (stats.pagesRead != 4 || stats.hits != 4 || stats.misses != 0) flag29 = false;
+		}
+
+		// without prewarm, the list is still written, but not used
+		options.prewarm = false;
+		{
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD", options);
+			this_thread::sleep_for(chrono::milliseconds(10));
+			if (myMgr.getNumReads() != 0) flag29 = false;
+		}
+		unlink("warmDSFSD");
+		if (flag29) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag29);
+
+	// keeping only a few files open at once
+	bool flag30 = true;
+	cout << "TEST 30..." << flush;
+	{
+		// counts this process's open files whose names have the given bit in them
+		auto countOpen = [] (string named) {
+			int numOpen = 0;
+			DIR *dir = opendir("/proc/self/fd");
+			while (struct dirent *entry = readdir(dir)) {
+				char target[1024];
+				ssize_t length = readlinkat(dirfd(dir), entry->d_name, target, sizeof(target) - 1);
+				if (length > 0 && string(target, length).find(named) != string::npos) numOpen++;
+			}
+			closedir(dir);
+			return numOpen;
+		};
+
+		vector<MyDB_TablePtr> tables;
+		for (int i = 0; i < 5; i++) {
+			tables.push_back(make_shared <MyDB_Table>("ftable" + to_string(i), "fdFileDSFSD" + to_string(i)));
+		}
+		MyDB_BufferOptions options;
+		options.maxOpenFiles = 2;
+		{
+			// there are only eight frames, so the dirty pages are written back all over the place
+			MyDB_BufferManager myMgr(64, 8, "tempDSFSD", options);
+			for (int j = 0; j < 4; j++) {
+				for (int i = 0; i < 5; i++) {
+					MyDB_PageHandle page = myMgr.getPage(tables[i], j);
+					memset(page->getBytes(), 'a' + i * 4 + j, 64);
+					page->wroteBytes();
+				}
+				if (countOpen("fdFileDSFSD") > 2) flag30 = false;
+			}
+
+			cout << "reopen..." << flush;
+			for (int i = 0; i < 5; i++) {
+				for (int j = 0; j < 4; j++) {
+					char *bytes = (char *)myMgr.getPage(tables[i], j)->getBytes();
+					if (bytes[0] != 'a' + i * 4 + j || bytes[63] != 'a' + i * 4 + j) flag30 = false;
+				}
+			}
+			MyDB_BufferStats stats = myMgr.getStats();
+			if (stats.openFiles > 2 || stats.fileOpens <= 5 || countOpen("fdFileDSFSD") > 2) flag30 = false;
+		}
+
+		// the pages in the buffer when it went away were written back, too
+		{
+			MyDB_BufferManager myMgr(64, 8, "tempDSFSD", options);
+			for (int i = 0; i < 5; i++) {
+				for (int j = 0; j < 4; j++) {
+					if (((char *)myMgr.getPage(tables[i], j)->getBytes())[10] != 'a' + i * 4 + j) flag30 = false;
+				}
+			}
+		}
+		if (countOpen("fdFileDSFSD") != 0) flag30 = false;
+		for (int i = 0; i < 5; i++) {
+			unlink(("fdFileDSFSD" + to_string(i)).c_str());
+		}
+		if (flag30) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag30);
+
+	// separate buffer pools for separate tables
+	bool flag31 = true;
+	cout << "TEST 31..." << flush;
+	{
+		// a small table kept in a pool of its own stays buffered through a big scan
+		// of another table, and anonymous pages go to the spill pool
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (64, 8, "tempDSFSD");
+		MyDB_BufferManagerPtr resident = make_shared <MyDB_BufferManager> (64, 4, "tempResidentDSFSD");
+		MyDB_BufferManagerPtr spill = make_shared <MyDB_BufferManager> (64, 4, "tempSpillDSFSD");
+		if (!myMgr->addPool("resident", resident) || !myMgr->addPool(SPILL_POOL, spill)) flag31 = false;
+
+		// pools that can't be added
+		if (myMgr->addPool("resident", make_shared <MyDB_BufferManager> (64, 4, "tempOtherDSFSD"))) flag31 = false;
+		if (myMgr->addPool("big", make_shared <MyDB_BufferManager> (128, 4, "tempOtherDSFSD"))) flag31 = false;
+		if (myMgr->addPool("", make_shared <MyDB_BufferManager> (64, 4, "tempOtherDSFSD"))) flag31 = false;
+		if (myMgr->getPool("resident") != resident || myMgr->getPool("big") != nullptr) flag31 = false;
+
+		MyDB_TablePtr dim = make_shared <MyDB_Table>("dim", "poolDimDSFSD");
+		dim->setBufferPool("resident");
+		MyDB_TablePtr fact = make_shared <MyDB_Table>("fact", "poolFactDSFSD");
+		for (int i = 0; i < 2; i++) {
+			MyDB_PageHandle page = myMgr->getPage(dim, i);
+			((char *)page->getBytes())[0] = 'd' + i;
+			page->wroteBytes();
+		}
+		for (int i = 0; i < 32; i++) {
+			MyDB_PageHandle page = myMgr->getPage(fact, i);
+			((char *)page->getBytes())[0] = 'a' + i;
+			page->wroteBytes();
+		}
+
+		// the scan went through the main pool only
+		MyDB_BufferStats residentBefore = resident->getStats();
+		if (residentBefore.misses != 2 || myMgr->getStats().misses < 32) flag31 = false;
+		for (int i = 0; i < 2; i++) {
+			if (((char *)myMgr->getPage(dim, i)->getBytes())[0] != 'd' + i) flag31 = false;
+		}
+		MyDB_BufferStats residentAfter = resident->getStats();
+		if (residentAfter.misses != 2 || residentAfter.hits != residentBefore.hits + 2) flag31 = false;
+
+		// the fact pages that were kicked out were written back
+		if (((char *)myMgr->getPage(fact, 0)->getBytes())[0] != 'a') flag31 = false;
+
+		// a sort puts its runs in the spill pool, with the anonymous pages; a table that is only
+		// named like a run stays in the main pool
+		MyDB_TablePtr run = make_shared <MyDB_Table>("temp_run_0", "poolRunDSFSD");
+		run->setBufferPool(SPILL_POOL);
+		MyDB_TablePtr notRun = make_shared <MyDB_Table>("temp_run_1", "poolNotRunDSFSD");
+		size_t spillMisses = spill->getStats().misses;
+		myMgr->getPage(run, 0)->getBytes();
+		myMgr->getPage(notRun, 0)->getBytes();
+		if (spill->getStats().misses != spillMisses + 1) flag31 = false;
+
+		// and no more pools can be added, now that pages have been handed out
+		if (myMgr->addPool("late", make_shared <MyDB_BufferManager> (64, 4, "tempOtherDSFSD"))) flag31 = false;
+
+		// an anonymous page goes to the spill pool
+		{
+			MyDB_PageHandle temp = myMgr->getPinnedPage();
+			((char *)temp->getBytes())[0] = 'x';
+			if (spill->getStats().tempPages != 1 || myMgr->getStats().tempPages != 0) flag31 = false;
+
+			// and a grant in the main pool can't hold the dimension table's pages
+			MyDB_MemoryGrantPtr grant = myMgr->reserve(2);
+			if (grant == nullptr || grant->getPinnedPage(dim, 0) != nullptr || grant->getPinnedPage(fact, 1) == nullptr) flag31 = false;
+			MyDB_MemoryGrantPtr residentGrant = myMgr->reserve(2, dim);
+			if (residentGrant == nullptr || residentGrant->getPinnedPage(dim, 0) == nullptr) flag31 = false;
+		}
+
+		// the buffer pool is kept in the catalog
+		{
+			MyDB_CatalogPtr catalog = make_shared <MyDB_Catalog> ("poolCatDSFSD");
+			MyDB_TablePtr toSave = make_shared <MyDB_Table>("saved", "poolSavedDSFSD", make_shared <MyDB_Schema> ());
+			toSave->setBufferPool("resident");
+			toSave->putInCatalog(catalog);
+			MyDB_Table loaded;
+			if (!loaded.fromCatalog("saved", catalog) || loaded.getBufferPool() != "resident") flag31 = false;
+		}
+		unlink("poolCatDSFSD");
+		unlink("poolDimDSFSD");
+		unlink("poolFactDSFSD");
+		unlink("poolRunDSFSD");
+		unlink("poolNotRunDSFSD");
+		if (flag31) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag31);
 }
 
 #endif
@@ -13,6 +13,10 @@ using namespace std;
 class MyDB_AttType;
 typedef shared_ptr <MyDB_AttType> MyDB_AttTypePtr;
 
+// the kinds of attributes there are; this is how a record's binary format lays
+// an attribute out (see MyDB_RecordLayout.h)
+enum MyDB_AttKind {IntAtt, DoubleAtt, StringAtt, BoolAtt};
+
 class MyDB_AttType {
 
 public:
@@ -24,6 +28,7 @@ public:
 	virtual MyDB_AttValPtr createAttMax () = 0;
 	virtual string toString () = 0;
 	virtual bool isBool () = 0;
+	virtual MyDB_AttKind getKind () = 0;
 };
 
 class MyDB_IntAttType : public MyDB_AttType {
@@ -52,6 +57,10 @@ public:
 		return false;
 	}
 
+	MyDB_AttKind getKind () {
+		return IntAtt;
+	}
+
 	MyDB_AttValPtr createAtt () {
 		return make_shared <MyDB_IntAttVal> ();
 	}	
@@ -90,6 +99,10 @@ public:
 		return false;
 	}
 
+	MyDB_AttKind getKind () {
+		return DoubleAtt;
+	}
+
 	MyDB_AttValPtr createAtt () {
 		return make_shared <MyDB_DoubleAttVal> ();
 	}	
@@ -123,6 +136,10 @@ public:
 		return false;
 	}
 
+	MyDB_AttKind getKind () {
+		return StringAtt;
+	}
+
 	string toString () {
 		return "string";
 	}
@@ -160,6 +177,10 @@ public:
 		return true;
 	}
 
+	MyDB_AttKind getKind () {
+		return BoolAtt;
+	}
+
 	string toString () {
 		return "bool";
 	}
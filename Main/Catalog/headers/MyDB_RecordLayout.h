@@ -0,0 +1,90 @@
+
+#ifndef RECORD_LAYOUT_H
+#define RECORD_LAYOUT_H
+
+#include "MyDB_AttType.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// records are written to pages in one of two formats.  The first (v1) starts with the size of
+// the record, as a short, and then has each attribute in turn, each with a short giving its
+// own size in front of it; so finding the k^th attribute means walking past the first k - 1.
+// The second (v2) is laid out from the schema:
+//
+//	short		the size of the record, negated (v1 sizes are always positive,
+//			and so the two formats can be told apart, even on the same page)
+//	fixed section	the ints, doubles, and bools, each at an offset that is the same for
+//			every record with the schema
+//	string table	for each string, an unsigned short giving the offset of its bytes
+//			from the start of the record
+//	strings		the strings' bytes, null-terminated
+//
+// so that any attribute can be found with at most one lookup.  This describes the v2
+// format for a schema; it is built up as attributes are added to the schema
+
+// where one attribute goes
+struct MyDB_AttLayout {
+
+	// what sort of attribute it is
+	MyDB_AttKind kind;
+
+	// for a fixed-size attribute, the offset of its bytes from the start of the record;
+	// for a string, its slot in the string table
+	size_t offset;
+};
+
+class MyDB_RecordLayout {
+
+public:
+
+	// an empty layout, for a schema with no attributes
+	MyDB_RecordLayout ();
+
+	// adds an attribute to the end of the layout
+	void append (string name, MyDB_AttKind kind);
+
+	// the index of the attribute with the given name; -1 if there is none
+	int getIndex (string &name);
+
+	// the number of attributes
+	size_t getNumAtts () {
+		return atts.size ();
+	}
+
+	// where the i^th attribute goes
+	MyDB_AttLayout &getAtt (size_t i) {
+		return atts[i];
+	}
+
+	// the offset of the string table from the start of a record
+	size_t getStringTableOffset () {
+		return fixedEnd;
+	}
+
+	// the number of strings in the record
+	size_t getNumStrings () {
+		return numStrings;
+	}
+
+	// the size of a record without its strings' bytes
+	size_t getMinSize () {
+		return fixedEnd + numStrings * sizeof (unsigned short);
+	}
+
+private:
+
+	// where each attribute goes, in order
+	vector <MyDB_AttLayout> atts;
+
+	// the index of each attribute, by name
+	unordered_map <string, int> byName;
+
+	// the end of the fixed section, and the number of strings
+	size_t fixedEnd;
+	size_t numStrings;
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include <iostream>
 #include "MyDB_AttType.h"
 #include "MyDB_Catalog.h"
+#include "MyDB_RecordLayout.h"
 #include <vector>
 
 using namespace std;
@@ -18,9 +19,13 @@ class MyDB_Schema {
 
 public:
 
-	// get a particular attribute... the pair is the index (first, second, third, etc.) and the type
+	// get a particular attribute... the pair is the index (first, second, third, etc.) and the type;
+	// the index is -1 (and the type a nullptr) if there is no such attribute
 	pair <int, MyDB_AttTypePtr> getAttByName (string findMe);
 
+	// how a record with this schema is laid out in binary (see MyDB_RecordLayout.h)
+	MyDB_RecordLayout &getLayout ();
+
 	// get the list of all of the attributes... the pair is the name and the type
 	vector <pair <string, MyDB_AttTypePtr>> &getAtts ();
 
@@ -45,6 +50,9 @@ private:
 	// this is a list, in order, of the attributes in the schema
 	// the string is the name of the attribute, and we also know the types
 	vector <pair <string, MyDB_AttTypePtr>> allAtts;
+
+	// the binary layout of the attributes, which also finds them by name
+	MyDB_RecordLayout layout;
 };
 
 #endif
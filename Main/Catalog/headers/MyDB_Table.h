@@ -78,6 +78,17 @@ public:
 	void setRootLocation (int toMe);
 	int getRootLocation ();
 
+	// get/set the size of the table's pages; 0 (the default) means that the table
+	// uses the buffer manager's page size.  A table with wide records can ask for
+	// bigger pages, as long as they are the buffer's page size times a power of two
+	size_t getPageSize ();
+	void setPageSize (size_t toMe);
+
+	// get/set the name of the buffer pool that the table's pages go into (see
+	// MyDB_BufferManager :: addPool); empty (the default) means the main one
+	string &getBufferPool ();
+	void setBufferPool (string toMe);
+
         // get the distinct value count for an attribute
         size_t getDistinctValues (string forMe);
         size_t getDistinctValues (int forMe);
@@ -117,6 +128,12 @@ private:
 
 	// location of the root node
 	int rootLocation;
+
+	// the page size; 0 if it is the buffer manager's
+	size_t pageSize;
+
+	// the buffer pool for the table's pages; empty if it is the main one
+	string bufferPool;
 };
 
 #endif
@@ -0,0 +1,40 @@
+
+#ifndef RECORD_LAYOUT_C
+#define RECORD_LAYOUT_C
+
+#include "MyDB_RecordLayout.h"
+
+using namespace std;
+
+MyDB_RecordLayout :: MyDB_RecordLayout () {
+	fixedEnd = sizeof (short);
+	numStrings = 0;
+}
+
+void MyDB_RecordLayout :: append (string name, MyDB_AttKind kind) {
+
+	// the first attribute with a name is the one that is found by name
+	byName.emplace (name, (int) atts.size ());
+
+	MyDB_AttLayout att;
+	att.kind = kind;
+	if (kind == StringAtt) {
+		att.offset = numStrings++;
+	} else {
+		att.offset = fixedEnd;
+		if (kind == IntAtt)
+			fixedEnd += sizeof (int);
+		else if (kind == DoubleAtt)
+			fixedEnd += sizeof (double);
+		else
+			fixedEnd += sizeof (char);
+	}
+	atts.push_back (att);
+}
+
+int MyDB_RecordLayout :: getIndex (string &name) {
+	auto found = byName.find (name);
+	return found == byName.end () ? -1 : found->second;
+}
+
+#endif
@@ -9,15 +9,11 @@ using namespace std;
 
 pair <int, MyDB_AttTypePtr> MyDB_Schema :: getAttByName (string findMe) {
 
-	// search for the information on a particular attributes
-	int counter = 0;
-	for (auto &entry : allAtts) {
-		if (entry.first == findMe) {
-			return make_pair (counter, entry.second);
-		} else {
-			counter++;
-		}
-	}	
+	// look up the information on a particular attribute
+	int which = layout.getIndex (findMe);
+	if (which != -1)
+		return make_pair (which, allAtts[which].second);
+
 	cout << "Could not find attribute " << findMe << "\n";
 	cout << "Candidates were: \n";
 	for (auto entry : allAtts) {
@@ -56,13 +52,13 @@ void MyDB_Schema :: fromCatalog (string tableName, MyDB_CatalogPtr catalog) {
 		string attType;
 		catalog->getString (tableName + "." + s + ".type", attType);
 		if (attType == "int") {
-			allAtts.push_back (make_pair (s, make_shared <MyDB_IntAttType> ()));
+			appendAtt (make_pair (s, make_shared <MyDB_IntAttType> ()));
 		} else if (attType == "double") {
-			allAtts.push_back (make_pair (s, make_shared <MyDB_DoubleAttType> ()));
+			appendAtt (make_pair (s, make_shared <MyDB_DoubleAttType> ()));
 		} else if (attType == "string") {
-			allAtts.push_back (make_pair (s, make_shared <MyDB_StringAttType> ()));
+			appendAtt (make_pair (s, make_shared <MyDB_StringAttType> ()));
 		} else if (attType == "bool") {
-			allAtts.push_back (make_pair (s, make_shared <MyDB_BoolAttType> ()));
+			appendAtt (make_pair (s, make_shared <MyDB_BoolAttType> ()));
 		} else {
 			cout << "Bad att type for attribute " << s << ": " << attType << "\n";
 			exit (1);
@@ -72,6 +68,11 @@ void MyDB_Schema :: fromCatalog (string tableName, MyDB_CatalogPtr catalog) {
 
 void MyDB_Schema :: appendAtt (pair <string, MyDB_AttTypePtr> addAtt) {
 	allAtts.push_back (addAtt);
+	layout.append (addAtt.first, addAtt.second->getKind ());
+}
+
+MyDB_RecordLayout &MyDB_Schema :: getLayout () {
+	return layout;
 }
 
 void MyDB_Schema :: putInCatalog (string tableName, MyDB_CatalogPtr catalog) {
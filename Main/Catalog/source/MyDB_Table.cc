@@ -11,6 +11,7 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn) {
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	pageSize = 0;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn) {
@@ -21,6 +22,7 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	pageSize = 0;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn, string fileTypeIn, string sortAttIn) {
@@ -31,6 +33,7 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = fileTypeIn;
 	sortAtt = sortAttIn;
 	rootLocation = -1;
+	pageSize = 0;
 }
 
 MyDB_Table :: ~MyDB_Table () {}
@@ -71,6 +74,22 @@ int MyDB_Table :: getRootLocation () {
 	return rootLocation;
 }
 
+size_t MyDB_Table :: getPageSize () {
+	return pageSize;
+}
+
+void MyDB_Table :: setPageSize (size_t toMe) {
+	pageSize = toMe;
+}
+
+string &MyDB_Table :: getBufferPool () {
+	return bufferPool;
+}
+
+void MyDB_Table :: setBufferPool (string toMe) {
+	bufferPool = toMe;
+}
+
 string &MyDB_Table :: getFileType () {
 	return fileType;
 }
@@ -102,7 +121,9 @@ map <string, MyDB_TablePtr> MyDB_Table :: getAllTables (MyDB_CatalogPtr fromMe)
 	return returnVal;
 }
 
-MyDB_Table :: MyDB_Table () {}
+MyDB_Table :: MyDB_Table () {
+	pageSize = 0;
+}
 
 int MyDB_Table :: lastPage () {
 	return last;
@@ -136,6 +157,15 @@ bool MyDB_Table :: fromCatalog (string tableNameIn, MyDB_CatalogPtr catalog) {
 	// get the root
 	catalog->getInt (tableName + ".rootLocation", rootLocation);
 
+	// get the page size; tables written before there was one use the buffer's
+	int size = 0;
+	catalog->getInt (tableName + ".pageSize", size);
+	pageSize = size;
+
+	// get the buffer pool; tables written before there were pools use the main one
+	bufferPool = "";
+	catalog->getString (tableName + ".bufferPool", bufferPool);
+
 	// get the number of distinct attribute vals
 	allCounts.clear ();
 	vector <string> temp;
@@ -176,6 +206,12 @@ void MyDB_Table :: putInCatalog (MyDB_CatalogPtr catalog) {
 	// and the root location
 	catalog->putInt (tableName + ".rootLocation", rootLocation);
 
+	// and the page size
+	catalog->putInt (tableName + ".pageSize", (int) pageSize);
+
+	// and the buffer pool
+	catalog->putString (tableName + ".bufferPool", bufferPool);
+
 	// remember the number of distinct attribute vals
 	vector <string> temp;
 	for (auto a : allCounts)
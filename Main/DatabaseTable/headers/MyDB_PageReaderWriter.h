@@ -13,11 +13,13 @@
 #ifndef PAGE_RW_H
 #define PAGE_RW_H
 
+#include <algorithm>
 #include <memory>
 #include "MyDB_PageType.h"
 #include "MyDB_RecordIterator.h"
 #include "MyDB_RecordIteratorAlt.h"
 #include "MyDB_TableReaderWriter.h"
+#include "MyDB_TypedRecord.h"
 
 using namespace std;
 class MyDB_PageReaderWriter;
@@ -36,6 +38,9 @@ public:
 	// constructor for an anonymous page
 	MyDB_PageReaderWriter (MyDB_BufferManager &parent);
 
+	// constructor for an anonymous page of the given size (see MyDB_BufferManager.h)
+	MyDB_PageReaderWriter (MyDB_BufferManager &parent, size_t pageSize);
+
 	// constructor for an anonymous page that can be pinned, if desired
 	MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager &parent);
 
@@ -64,6 +69,12 @@ public:
 	// a nullptr
 	void *appendAndReturnLocation (MyDB_RecordPtr appendMe);
 
+	// same as append, for a typed record (see MyDB_TypedRecord.h)
+	template <typename... Ts>
+	bool append (MyDB_TypedRecord <Ts...> &appendMe) {
+		return appendBytes (appendMe.getBinary (), appendMe.getBinarySize ());
+	}
+
 	// gets the type of this page... this is just a value from an ennumeration
 	// that is stored within the page
 	MyDB_PageType getType ();
@@ -80,6 +91,39 @@ public:
 	// like the above, except that the sorting is done in place, on the page
 	void sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs);
 
+	// same as the above two, but with a typed comparator (see MyDB_TypedRecord.h), which looks
+	// at the records where they are, and so no records are needed at all.  The comparator can't
+	// read records in the old (v1) format, so if there are any on the page, nothing is done, and
+	// sort returns a nullptr (sortInPlace returns false)
+	template <class Rec, size_t i>
+	MyDB_PageReaderWriterPtr sort (MyDB_TypedComparator <Rec, i> comparator) {
+		vector <void *> positions;
+		void *temp = copyBytes ();
+		findRecords (positions, temp);
+		MyDB_PageReaderWriterPtr returnVal = nullptr;
+		if (allReadable <Rec> (positions)) {
+			std::stable_sort (positions.begin (), positions.end (), comparator);
+			returnVal = make_shared <MyDB_PageReaderWriter> (myPage->getParent (), pageSize);
+			returnVal->writeRecords (positions);
+		}
+		free (temp);
+		return returnVal;
+	}
+
+	template <class Rec, size_t i>
+	bool sortInPlace (MyDB_TypedComparator <Rec, i> comparator) {
+		vector <void *> positions;
+		void *temp = copyBytes ();
+		findRecords (positions, temp);
+		bool readable = allReadable <Rec> (positions);
+		if (readable) {
+			std::stable_sort (positions.begin (), positions.end (), comparator);
+			writeRecords (positions);
+		}
+		free (temp);
+		return readable;
+	}
+
 	// returns the page size
 	size_t getPageSize ();
 
@@ -88,6 +132,28 @@ public:
 
 private:
 
+	// appends the record with the given bytes to the page, if there is room
+	bool appendBytes (void *bytes, size_t size);
+
+	// a copy of the page's bytes, which must be freed
+	void *copyBytes ();
+
+	// finds where each of the records is in the given copy of the page (or in the page itself)
+	void findRecords (vector <void *> &positions, void *bytes);
+
+	// empties out the page, and then writes the records at the given positions to it, in order
+	void writeRecords (vector <void *> &positions);
+
+	// true if the records at the given positions can all be read as typed records of type Rec
+	template <class Rec>
+	static bool allReadable (vector <void *> &positions) {
+		for (void *pos : positions) {
+			if (!Rec :: readable (pos))
+				return false;
+		}
+		return true;
+	}
+
 	// this is the page that we are messing with
 	MyDB_PageHandle myPage;	
 	
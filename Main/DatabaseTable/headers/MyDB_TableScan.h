@@ -0,0 +1,125 @@
+
+#ifndef TABLE_SCAN_H
+#define TABLE_SCAN_H
+
+#include "MyDB_PageHandle.h"
+#include "MyDB_Record.h"
+#include "MyDB_TableReaderWriter.h"
+#include "MyDB_TypedRecord.h"
+
+// goes through all of the records in a table as cheaply as possible.  Each page is pinned
+// while its records are gone through, and each record is viewed right where it is on the
+// page (see MyDB_Record :: viewBinary), rather than being copied out; nothing is allocated
+// for each page or record.  Usage:
+//
+//	MyDB_TableScan scan (myTable, myRec);
+//	while (scan.next ()) {
+//		... use myRec, or computations compiled over it ...
+//	}
+//
+// the record is only good until the next call to next (); if it is needed after that, it
+// has to be copied (for example, with toBinary).  If a page can not be pinned because
+// every frame holds a pinned page, its records are copied into the record instead.  If
+// the page can't even be read into a frame (even after waiting out the buffer's pin
+// timeout), the scan stops early, and failed () is true.  Note that, like any pinned
+// page, a page that someone else also has a handle to stays pinned until that handle
+// goes away, too
+class MyDB_TableScan {
+
+public:
+
+	// sets up a scan of the table, with each record viewed by viewer
+	MyDB_TableScan (MyDB_TableReaderWriter &table, MyDB_RecordPtr viewer);
+
+	// moves on to the next record in the table; false if there are no more
+	bool next ();
+
+	// same, but the record is not read: this returns where its bytes are, or nullptr if there
+	// are no more.  They are good until the next call if the page is pinned (see isPinned);
+	// otherwise, only until the buffer manager is used again.  The scan's record is not used
+	// by this, and so it can be nullptr
+	void *nextBinary ();
+
+	// true if the page that the last record was on is pinned
+	bool isPinned ();
+
+	// true if the scan stopped before the end of the table, because there was no frame
+	// for a page
+	bool failed ();
+
+private:
+
+	// moves on to the next page; false if there are no more
+	bool nextPage ();
+
+	MyDB_TableReaderWriter &table;
+	MyDB_RecordPtr viewer;
+
+	// the page that the records are on, whether it is pinned, and its bytes (which stay put
+	// only if it is pinned)
+	MyDB_PageHandle page;
+	bool pinned;
+	char *bytes;
+
+	// set if there was no frame for a page
+	bool noFrame;
+
+	// the page's position in the table, and where we are on the page
+	long whichPage;
+	size_t bytesConsumed;
+	size_t bytesUsed;
+};
+
+// same, but each record is a typed record (see MyDB_TypedRecord.h), which the table's schema
+// must match.  A record in the old (v1) format can't be viewed as a typed record, so it is read
+// through a MyDB_Record instead, and copied into the typed record.  Usage:
+//
+//	MyDB_TypedRecord <int, double> myRec;
+//	MyDB_TypedTableScan <MyDB_TypedRecord <int, double>> scan (myTable, myRec);
+//	while (scan.next ()) {
+//		... use myRec.get <0> () and myRec.get <1> () ...
+//	}
+template <class Rec>
+class MyDB_TypedTableScan {
+
+public:
+
+	MyDB_TypedTableScan (MyDB_TableReaderWriter &table, Rec &viewerIn) : scan (table, nullptr), viewer (viewerIn) {
+		if (!Rec :: matches (table.getTable ()->getSchema ())) {
+			cout << "Can't scan " << table.getTable ()->getName () << " as a typed record that does not match its schema!!\n";
+			exit (1);
+		}
+		oldFormat = table.getEmptyRecord ();
+	}
+
+	bool next () {
+		void *pos = scan.nextBinary ();
+		if (pos == nullptr)
+			return false;
+
+		if (!Rec :: readable (pos)) {
+			oldFormat->fromBinary (pos);
+			viewer.fromRecord (*oldFormat);
+		} else if (scan.isPinned ()) {
+			viewer.viewBinary (pos);
+		} else {
+			viewer.fromBinary (pos);
+		}
+		return true;
+	}
+
+	// see MyDB_TableScan :: failed
+	bool failed () {
+		return scan.failed ();
+	}
+
+private:
+
+	MyDB_TableScan scan;
+	Rec &viewer;
+
+	// where a record in the old format is read
+	MyDB_RecordPtr oldFormat;
+};
+
+#endif
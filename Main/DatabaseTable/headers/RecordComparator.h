@@ -17,9 +17,10 @@ public:
 		rhs = rhsIn;
 	}
 
+	// the records are compared where they are, without copying them
 	bool operator () (void *lhsPtr, void *rhsPtr) {
-		lhs->fromBinary (lhsPtr);
-		rhs->fromBinary (rhsPtr);
+		lhs->viewBinary (lhsPtr);
+		rhs->viewBinary (rhsPtr);
 		return comparator ();	
 	}
 
@@ -13,12 +13,37 @@
 void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
         function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
 
+// same, except that each page is sorted in place using sortPage, rather than with comparator
+void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
+	function <void (MyDB_PageReaderWriter &)> sortPage, function <bool ()> comparator, MyDB_RecordPtr lhs,
+	MyDB_RecordPtr rhs);
+
+// same, but with a typed comparator (see MyDB_TypedRecord.h); the pages are sorted without any records,
+// and lhs and rhs (which must have a schema that matches Rec) are only used for the merges.  A page with
+// records in the old (v1) format, which the comparator can't read, is sorted through lhs and rhs instead
+template <class Rec, size_t i>
+void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
+	MyDB_TypedComparator <Rec, i> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+
+	if (!Rec :: matches (sortMe.getTable ()->getSchema ())) {
+		cout << "Can't sort " << sortMe.getTable ()->getName () << " as a typed record that does not match its schema!!\n";
+		exit (1);
+	}
+	function <bool ()> overRecords = comparator.over (lhs, rhs);
+	sort (runSize, sortMe, sortIntoMe, [comparator, overRecords, lhs, rhs] (MyDB_PageReaderWriter &page) {
+			if (!page.sortInPlace (comparator))
+				page.sortInPlace (overRecords, lhs, rhs);
+		}, overRecords, lhs, rhs);
+}
+
 // helper function.  Gets two iterators, leftIter and rightIter.  It is assumed that these are iterators over
 // sorted lists of records.  This function then merges all of those records into a list of anonymous pages,
 // and returns the list of anonymous pages to the caller.  The resulting list of anonymous pages is sorted.
-// Comparisons are performed using comparator, lhs, rhs
+// Comparisons are performed using comparator, lhs, rhs.  The anonymous pages are pageSize bytes, or the
+// buffer's page size if that is 0
 vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter,
-        MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
+        MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs,
+	size_t pageSize = 0);
 
 // accepts a list of iterators called mergeUs.  It is assumed that these are all iterators over sorted lists
 // of records.  This function then merges all of those records and appends them to the file sortIntoMe.  If
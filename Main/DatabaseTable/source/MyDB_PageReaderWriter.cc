@@ -28,7 +28,7 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent,
 
 	// get the actual page
 	myPage = parent.getBufferMgr ()->getPage (parent.getTable (), whichPage);
-	pageSize = parent.getBufferMgr ()->getPageSize ();
+	pageSize = parent.getBufferMgr ()->getPageSize (parent.getTable ());
 }
 
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWriter &parent, int whichPage) {
@@ -39,7 +39,7 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWri
 	} else {
 		myPage = parent.getBufferMgr ()->getPage (parent.getTable (), whichPage);
 	}
-	pageSize = parent.getBufferMgr ()->getPageSize ();
+	pageSize = parent.getBufferMgr ()->getPageSize (parent.getTable ());
 }
 
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_BufferManager &parent) {
@@ -48,6 +48,12 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_BufferManager &parent) {
 	clear ();
 }
 
+MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_BufferManager &parent, size_t pageSizeIn) {
+	myPage = parent.getPage (pageSizeIn);
+	pageSize = pageSizeIn;
+	clear ();
+}
+
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager &parent) {
 
 	if (pinned) {
@@ -108,68 +114,86 @@ bool MyDB_PageReaderWriter :: append (MyDB_RecordPtr appendMe) {
 	return true;
 }
 
-void MyDB_PageReaderWriter :: 
-	sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
+bool MyDB_PageReaderWriter :: appendBytes (void *bytes, size_t size) {
 
+	if (size > NUM_BYTES_LEFT)
+		return false;
+
+	memcpy (NUM_BYTES_USED + (char *) myPage->getBytes (), bytes, size);
+	NUM_BYTES_USED += size;
+	myPage->wroteBytes ();
+	return true;
+}
+
+void *MyDB_PageReaderWriter :: copyBytes () {
 	void *temp = malloc (pageSize);
 	memcpy (temp, myPage->getBytes (), pageSize);
+	return temp;
+}
+
+void MyDB_PageReaderWriter :: findRecords (vector <void *> &positions, void *bytes) {
 
-	// first, read in the positions of all of the records
-	vector <void *> positions;
-	
 	// this basically iterates through all of the records on the page
-	int bytesConsumed = sizeof (size_t) * 2;
+	size_t bytesConsumed = sizeof (size_t) * 2;
 	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) temp;
+		void *pos = bytesConsumed + (char *) bytes;
 		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
+		bytesConsumed += MyDB_Record :: getBinarySize (pos);
 	}
+}
+
+void MyDB_PageReaderWriter :: writeRecords (vector <void *> &positions) {
+	clear ();
+	for (void *pos : positions)
+		appendBytes (pos, MyDB_Record :: getBinarySize (pos));
+}
+
+void MyDB_PageReaderWriter :: 
+	sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
+
+	// first, read in the positions of all of the records, in a copy of the page
+	vector <void *> positions;
+	void *temp = copyBytes ();
+	findRecords (positions, temp);
 
 	// and now we sort the vector of positions, using the record contents to build a comparator
 	RecordComparator myComparator (comparator, lhs, rhs);
 	std::stable_sort (positions.begin (), positions.end (), myComparator);
 
 	// and write the guys back
-	NUM_BYTES_USED = 2 * sizeof (size_t);
-	myPage->wroteBytes ();	
-	for (void *pos : positions) {
-		lhs->fromBinary (pos);
-		append (lhs);
-	}
+	writeRecords (positions);
 
+	// the records were looking at the copy of the page, which is about to go away
+	if (positions.size () > 0) {
+		lhs->fromBinary (positions[0]);
+		rhs->fromBinary (positions[0]);
+	}
 	free (temp);
 }
 
 MyDB_PageReaderWriterPtr MyDB_PageReaderWriter :: 
 	sort (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
 
-	// first, read in the positions of all of the records
+	// first, read in the positions of all of the records, in a copy of the page (this page is not
+	// pinned, so getting a frame for the new one below could take its frame away)
 	vector <void *> positions;
-	
-	// this basically iterates through all of the records on the page
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) myPage->getBytes ();
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
-	}
+	void *temp = copyBytes ();
+	findRecords (positions, temp);
 
 	// and now we sort the vector of positions, using the record contents to build a comparator
 	RecordComparator myComparator (comparator, lhs, rhs);
 	std::stable_sort (positions.begin (), positions.end (), myComparator);
 
-	// and now create the page to return
-	MyDB_PageReaderWriterPtr returnVal = make_shared <MyDB_PageReaderWriter> (myPage->getParent ());
-	returnVal->clear ();
-	
-	// loop through all of the sorted records and write them out
-	for (void *pos : positions) {
-		lhs->fromBinary (pos);
-		returnVal->append (lhs);
-	}
+	// and now create the page to return, with all of the sorted records written out
+	MyDB_PageReaderWriterPtr returnVal = make_shared <MyDB_PageReaderWriter> (myPage->getParent (), pageSize);
+	returnVal->writeRecords (positions);
 
+	// the records were looking at the copy of the page, which is about to go away
+	if (positions.size () > 0) {
+		lhs->fromBinary (positions[0]);
+		rhs->fromBinary (positions[0]);
+	}
+	free (temp);
 	return returnVal;
 }
 
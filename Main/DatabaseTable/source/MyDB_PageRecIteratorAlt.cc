@@ -40,7 +40,7 @@ bool MyDB_PageRecIteratorAlt :: advance () {
 
 MyDB_PageRecIteratorAlt :: MyDB_PageRecIteratorAlt (MyDB_PageHandle myPageIn) {
 	bytesConsumed = sizeof (size_t) * 2;
-	myPage = myPageIn;
+	myPage = std :: move (myPageIn);
 	nextRecSize = 0;
 }
 
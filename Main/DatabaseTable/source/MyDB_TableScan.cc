@@ -0,0 +1,92 @@
+
+#ifndef TABLE_SCAN_C
+#define TABLE_SCAN_C
+
+#include "MyDB_PageType.h"
+#include "MyDB_TableScan.h"
+
+MyDB_TableScan :: MyDB_TableScan (MyDB_TableReaderWriter &tableIn, MyDB_RecordPtr viewerIn) : table (tableIn) {
+	viewer = viewerIn;
+	pinned = false;
+	bytes = nullptr;
+	noFrame = false;
+	whichPage = -1;
+	bytesConsumed = 0;
+	bytesUsed = 0;
+}
+
+bool MyDB_TableScan :: next () {
+
+	void *pos = nextBinary ();
+	if (pos == nullptr)
+		return false;
+
+	if (pinned)
+		viewer->viewBinary (pos);
+	else
+		viewer->fromBinary (pos);
+	return true;
+}
+
+void *MyDB_TableScan :: nextBinary () {
+
+	while (bytesConsumed == bytesUsed) {
+		if (!nextPage ())
+			return nullptr;
+	}
+
+	// an unpinned page's bytes may have moved since the last record (or been kicked out, with
+	// no frame to read them back into)
+	if (!pinned) {
+		bytes = (char *) page->getBytes ();
+		if (bytes == nullptr) {
+			noFrame = true;
+			page = nullptr;
+			bytesConsumed = bytesUsed = 0;
+			whichPage = table.getTable ()->lastPage ();
+			return nullptr;
+		}
+	}
+
+	char *pos = bytes + bytesConsumed;
+	bytesConsumed += MyDB_Record :: getBinarySize (pos);
+	return pos;
+}
+
+bool MyDB_TableScan :: isPinned () {
+	return pinned;
+}
+
+bool MyDB_TableScan :: failed () {
+	return noFrame;
+}
+
+bool MyDB_TableScan :: nextPage () {
+
+	// let go of the last page first, so that its frame can be used for the next one
+	page = nullptr;
+	if (whichPage >= table.getTable ()->lastPage ())
+		return false;
+	whichPage++;
+
+	page = table.getBufferMgr ()->getPinnedPage (table.getTable (), whichPage);
+	pinned = page != nullptr;
+	if (!pinned)
+		page = table.getBufferMgr ()->getPage (table.getTable (), whichPage);
+
+	// only regular pages have records on them
+	bytes = (char *) page->getBytes ();
+	if (bytes == nullptr) {
+		noFrame = true;
+		page = nullptr;
+		whichPage = table.getTable ()->lastPage ();
+		return false;
+	}
+	bytesConsumed = 2 * sizeof (size_t);
+	bytesUsed = 2 * sizeof (size_t);
+	if (*((MyDB_PageType *) bytes) == MyDB_PageType :: RegularPage)
+		bytesUsed = *((size_t *) (bytes + sizeof (size_t)));
+	return true;
+}
+
+#endif
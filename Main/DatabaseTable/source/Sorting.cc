@@ -74,12 +74,15 @@ void mergeIntoFile (MyDB_TableReaderWriter &sortIntoMe, vector <MyDB_RecordItera
 // and returns the list of anonymous pages to the caller.  The resulting list of anonymous pages is sorted.
 // Comparisons are performed using comparator, lhs, rhs
 vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter,
-        MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+        MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs,
+	size_t pageSize) {
 
 			vector<MyDB_PageReaderWriter> returnVector;
+			if (pageSize == 0)
+				pageSize = parent->getPageSize ();
 
 			// Get the first anonymous page to start writing to
-			MyDB_PageReaderWriter currPage(*parent);
+			MyDB_PageReaderWriter currPage(*parent, pageSize);
 			currPage.clear();
 			returnVector.push_back(currPage);
 
@@ -100,7 +103,7 @@ vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB
 					// Append lhs and advance left iterator.
 					if (!currPage.append(lhs)) {
 						// Could not append to currPage. Page is full. Get a new one. Append to returnVector.
-						currPage = MyDB_PageReaderWriter(*parent);
+						currPage = MyDB_PageReaderWriter(*parent, pageSize);
 						currPage.clear();
 						currPage.append(lhs);
 						returnVector.push_back(currPage);
@@ -113,7 +116,7 @@ vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB
 					// Append rhs and advance the right iterator. 
 					if (!currPage.append(rhs)) {
 						// Could not append to currPage. Page is full. Get a new one. Append to returnVector.
-						currPage = MyDB_PageReaderWriter(*parent);
+						currPage = MyDB_PageReaderWriter(*parent, pageSize);
 						currPage.clear();
 						currPage.append(rhs);
 						returnVector.push_back(currPage);
@@ -131,6 +134,13 @@ vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB
 // size for the first phase of the TPMMS is given by runSize.  Comparisons are performed 
 // using comparator, lhs, rhs
 void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+	sort (runSize, sortMe, sortIntoMe, [&] (MyDB_PageReaderWriter &page) {page.sortInPlace (comparator, lhs, rhs);},
+		comparator, lhs, rhs);
+}
+
+// the TPMMS itself; each page is sorted using sortPage
+void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe, function <void (MyDB_PageReaderWriter &)> sortPage,
+	function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
 	
 	/* PHASE 1: GENERATE ALL SORTED RUNS */
 
@@ -141,7 +151,17 @@ void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &
 		
 		// 1.1 Create a new temporary table for this run. 
 		string runName = "temp_run_" + to_string(i / runSize);
+
+		// The run table has the same size pages as the table being sorted (and a name of its own
+		// if that is not the default size, since all tables with the same name share one file)
+		if (sortMe.getTable()->getPageSize() != 0)
+			runName += "_" + to_string(sortMe.getTable()->getPageSize());
 		MyDB_TablePtr runTablePtr = make_shared<MyDB_Table>(runName, runName + ".bin", sortMe.getTable()->getSchema());
+		runTablePtr->setPageSize(sortMe.getTable()->getPageSize());
+
+		// Runs are scratch data, so they go in the buffer's spill pool (if it has none, they stay
+		// in the buffer itself)
+		runTablePtr->setBufferPool(SPILL_POOL);
 		MyDB_TableReaderWriterPtr runTableSortIntoMe = make_shared<MyDB_TableReaderWriter>(runTablePtr, sortMe.getBufferMgr());
 		tempRuns.push_back(runTableSortIntoMe);
 
@@ -153,17 +173,31 @@ void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &
 		// Determine the total number of pages for this run. Handles the last, smaller run of pages.
 		int pagesInThisRun = min(runSize, numPages - i);
 
-		// 1.2.1.  Load a run of pages into RAM
+		// 1.2.1.  Load a run of pages into RAM. If there are frames for all of them, they are set aside
+		// for the run (in the pool that the table's pages go into) and the pages are pinned together, so
+		// that the ones not buffered are read with a few big reads rather than one at a time, and nobody
+		// else can take the frames while we load
+		size_t framesPerPage = sortMe.getBufferMgr()->getPageSize(sortMe.getTable()) / sortMe.getBufferMgr()->getPageSize();
+		MyDB_MemoryGrantPtr runGrant = sortMe.getBufferMgr()->reserve(pagesInThisRun * framesPerPage, sortMe.getTable());
+		MyDB_PageRangePtr runPages;
+		if (runGrant != nullptr)
+			runPages = runGrant->pinRange(sortMe.getTable(), i, pagesInThisRun);
+		else
+			runPages = sortMe.getBufferMgr()->pinRange(sortMe.getTable(), i, pagesInThisRun);
 		for (int j = 0; j < pagesInThisRun; j++) {
-			// Get page
-			MyDB_PageReaderWriter currPage(sortMe[i + j]);
-
 			// Sort the records in the page in RAM
-			currPage.sortInPlace(comparator, lhs, rhs);
+			MyDB_PageReaderWriter currPage(sortMe[i + j]);
+			sortPage(currPage);
+		}
 
+		// The merges below need frames of their own, so the pages do not stay pinned (or set aside).
+		// A pinned page stays pinned while anyone has a handle to it, so the handles used to sort the
+		// pages are all gone by now, and the ones kept for the merges are only made after this
+		runPages = nullptr;
+		runGrant = nullptr;
+		for (int j = 0; j < pagesInThisRun; j++) {
 			// Add this single, sorted page as a new run.
-			inMemoryRunPages.push_back({currPage});
-
+			inMemoryRunPages.push_back({sortMe[i + j]});
 		}
 
 		// 1.2.3. Merging runs in memory
@@ -177,7 +211,8 @@ void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &
 				} else {
 					MyDB_RecordIteratorAltPtr leftIter = make_shared<MyDB_PageListIteratorAlt>(inMemoryRunPages[j]);
 					MyDB_RecordIteratorAltPtr rightIter = make_shared<MyDB_PageListIteratorAlt>(inMemoryRunPages[j+1]);
-					vector<MyDB_PageReaderWriter> mergedRun = mergeIntoList(sortMe.getBufferMgr(), leftIter, rightIter, comparator, lhs, rhs);
+					vector<MyDB_PageReaderWriter> mergedRun = mergeIntoList(sortMe.getBufferMgr(), leftIter, rightIter, comparator, lhs, rhs,
+						sortMe.getBufferMgr()->getPageSize(sortMe.getTable()));
 					nextDepthRuns.push_back(mergedRun);
 				}
 			}
@@ -98,6 +98,12 @@ public:
 	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
 	void set (int val);
 	MyDB_IntAttVal ();
+
+	// same as toInt, but not virtual
+	inline int get () {
+		void *dataPtr = getDataPointer ();
+		return dataPtr == nullptr ? value : *((int *) dataPtr);
+	}
 	~MyDB_IntAttVal ();
 
 private:
@@ -124,6 +130,12 @@ public:
 	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
 	void set (double val);
 	MyDB_DoubleAttVal ();
+
+	// same as toDouble, but not virtual
+	inline double get () {
+		void *dataPtr = getDataPointer ();
+		return dataPtr == nullptr ? value : *((double *) dataPtr);
+	}
 	~MyDB_DoubleAttVal ();
 
 private:
@@ -150,6 +162,13 @@ public:
 	void fromInt (int fromMe) override;
 	void set (string val);
 	MyDB_StringAttVal ();
+
+	// same as toString, but the string is not copied: this points at its bytes (which are
+	// null-terminated), and it is good until the value is changed or the record is read again
+	inline const char *getChars () {
+		void *dataPtr = getDataPointer ();
+		return dataPtr == nullptr ? value.c_str () : (char *) dataPtr;
+	}
 	~MyDB_StringAttVal ();
 
 private:
@@ -176,6 +195,12 @@ public:
 	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
 	void set (bool val);
 	MyDB_BoolAttVal ();
+
+	// same as toBool, but not virtual
+	inline bool get () {
+		void *dataPtr = getDataPointer ();
+		return dataPtr == nullptr ? value : *((char *) dataPtr) == 1;
+	}
 	~MyDB_BoolAttVal ();
 
 private:
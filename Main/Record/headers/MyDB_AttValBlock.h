@@ -0,0 +1,38 @@
+
+#ifndef ATT_VAL_BLOCK_H
+#define ATT_VAL_BLOCK_H
+
+#include "MyDB_AttVal.h"
+#include "MyDB_RecordLayout.h"
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// the values for all of the attributes of a record, kept together: there is one array of
+// values for each type, and the attributes of that type have their values next to each
+// other in it.  This means that making the values for a record takes a few allocations
+// (one for the block, and one for each type), no matter how many attributes it has,
+// rather than one for each attribute... and since the record knows the type of each of
+// its attributes from its layout, it can get at the value without a virtual call
+class MyDB_AttValBlock {
+
+public:
+
+	// makes a block with the values for the attributes in the layout, and puts a pointer
+	// to each one, in order, on the end of values; the pointers all share the block, and
+	// so it goes away when the last of them does
+	static void fill (MyDB_RecordLayout &layout, vector <MyDB_AttValPtr> &values);
+
+	// a block with room for the given number of values of each type
+	MyDB_AttValBlock (size_t numInts, size_t numDoubles, size_t numStrings, size_t numBools);
+
+private:
+
+	vector <MyDB_IntAttVal> ints;
+	vector <MyDB_DoubleAttVal> doubles;
+	vector <MyDB_StringAttVal> strings;
+	vector <MyDB_BoolAttVal> bools;
+};
+
+#endif
@@ -62,6 +62,22 @@ public:
 	// 	
 	void *fromBinary (void *startPos);
 
+	// same as fromBinary, except that the record's bytes are not copied: the record is a
+	// read-only view of them where they are (typically, on a page), and so they must stay
+	// put (the page must stay pinned) until the record is read again, or written.  An
+	// attribute that is set after this does not change the bytes viewed
+	void *viewBinary (void *startPos);
+
+	// the record's bytes (the buffer, or the bytes being viewed), which are written first if
+	// the record has changed; these are what toBinary copies
+	void *getBinary ();
+
+	// the number of bytes taken up by the record at startPos, in either format
+	static inline size_t getBinarySize (void *startPos) {
+		short header = *((short *) startPos);
+		return header < 0 ? -header : header;
+	}
+
 	// parse the contents of this record from the given string
 	void fromString (string fromMe);
 
@@ -112,9 +128,33 @@ public:
 	// access the schema
 	MyDB_SchemaPtr &getSchema ();
 
-	// access a particular attribute
+	// access a particular attribute... if the record was read from binary, this is when the
+	// attribute is found in it
 	MyDB_AttValPtr &getAtt (int whichAtt);
 
+	// the same as getAtt (whichAtt)->toInt () (and so on), but with no virtual call, and (for a
+	// string) no copy: the attribute must be of that type.  A string is null-terminated, and is
+	// good until the attribute is changed or the record is read again
+	inline int getInt (int whichAtt) {
+		resolve (whichAtt);
+		return static_cast <MyDB_IntAttVal *> (values[whichAtt].get ())->get ();
+	}
+
+	inline double getDouble (int whichAtt) {
+		resolve (whichAtt);
+		return static_cast <MyDB_DoubleAttVal *> (values[whichAtt].get ())->get ();
+	}
+
+	inline bool getBool (int whichAtt) {
+		resolve (whichAtt);
+		return static_cast <MyDB_BoolAttVal *> (values[whichAtt].get ())->get ();
+	}
+
+	inline const char *getChars (int whichAtt) {
+		resolve (whichAtt);
+		return static_cast <MyDB_StringAttVal *> (values[whichAtt].get ())->getChars ();
+	}
+
 private:
 
 	// for fast reading from a page; the contents of the record are simply copied into this buffer
@@ -126,6 +166,12 @@ private:
 	// the amount of data in the record buffer
 	size_t recSize;
 
+	// where the record's bytes are: the buffer, or the bytes being viewed (see viewBinary)
+	char *base;
+
+	// sets up the attributes for the record at base, which starts with the given header
+	void setUpAtts (short header);
+
 	// helper function for the compilation
 	pair <func, MyDB_AttTypePtr> compileHelper (char * &vals);
 
@@ -147,9 +193,43 @@ private:
 	pair <func, MyDB_AttTypePtr> unaryMinus (pair <func, MyDB_AttTypePtr> lhs);
 	pair <func, MyDB_AttTypePtr> nott (pair <func, MyDB_AttTypePtr> lhs);
 
-	// write the current attribute values into the buffer
+	// write the current attribute values into the buffer... the new binary format (see
+	// MyDB_RecordLayout.h) is used if the record's attributes match its schema
 	void writeAttsToBuffer ();
 
+	// true if the record's attributes match its schema, so its layout can be used
+	bool usesLayout ();
+
+	// points the attribute at its value in the record's bytes, which are in the new format
+	void pointAttAtBuffer (size_t whichAtt) const;
+
+	// a record read in the new format is read lazily: its attributes are only pointed at the
+	// buffer when they are first used (through getAtt or a compiled computation), so reading
+	// a record costs the same no matter how many attributes it has.  An attribute has been
+	// pointed at the record in the buffer if its entry here is numRead, the number of records
+	// read so far... values that are set are never pointed at the buffer after that
+	mutable vector <size_t> pointedAt;
+	size_t numRead;
+
+	// false if every attribute is to be pointed at the buffer as soon as a record is read; for
+	// records whose attributes are shared with others (see buildFrom)
+	bool lazy;
+
+	// points the attribute at the buffer, if it has not been already
+	inline void resolve (size_t whichAtt) const {
+		if (whichAtt < pointedAt.size () && pointedAt[whichAtt] != numRead)
+			pointAttAtBuffer (whichAtt);
+	}
+
+	// same, for every attribute
+	void resolveAll () const;
+
+	// marks every attribute as set up for the current record
+	void markResolved ();
+
+	// where the strings are put while the record is written to the buffer
+	vector <string> strings;
+
 	// true when the set of attributes don't match the attribute buffer
 	bool bufferOld;
 
@@ -157,6 +237,9 @@ private:
 	friend class MyDB_INRecord;
 
 	MyDB_SchemaPtr mySchema;
+
+	// the values of the attributes; for a record made from a schema, these all share one
+	// MyDB_AttValBlock
 	vector <MyDB_AttValPtr> values;	
 	vector <MyDB_AttValPtr> scratch;
 
@@ -0,0 +1,344 @@
+
+#ifndef TYPED_RECORD_H
+#define TYPED_RECORD_H
+
+#include "MyDB_Record.h"
+#include "MyDB_Schema.h"
+#include <iostream>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+// a record whose schema is known when the code is compiled, for the tables that are used so much
+// that working through a MyDB_Record costs too much.  For example, the index/value table is
+//
+//	typedef MyDB_TypedRecord <int, double> IndexValueRec;
+//
+// and then rec.get <1> () is the value of a record.  The attributes can be ints, doubles, bools,
+// and strings (a string attribute is given as string, and its value is a const char *).  A typed
+// record is written in exactly the same format as a MyDB_Record with the same schema (the v2
+// format, see MyDB_RecordLayout.h), but since the offsets are all worked out by the compiler,
+// getting at an attribute is a single load.  Records written with the old (v1) format can not be
+// viewed this way, but they can be read through a MyDB_Record (see fromRecord).  See
+// MyDB_TypedComparator below for sorting with a typed record
+
+// how one type of attribute is laid out; fixedSize is the number of bytes that the attribute takes in
+// the fixed section of a record, and where is its offset (for a fixed-size attribute) or its slot in
+// the string table (for a string)
+template <typename T> struct MyDB_TypedAtt;
+
+template <> struct MyDB_TypedAtt <int> {
+	typedef int Value;
+	static constexpr MyDB_AttKind kind = IntAtt;
+	static constexpr size_t fixedSize = sizeof (int);
+	static constexpr size_t numStrings = 0;
+	static inline Value read (const char *rec, size_t where, size_t) {
+		return *((int *) (rec + where));
+	}
+	static inline void write (char *rec, size_t where, size_t, Value val, size_t &) {
+		*((int *) (rec + where)) = val;
+	}
+	static inline size_t extraBytes (Value) {
+		return 0;
+	}
+	static inline Value fromRecord (MyDB_Record &rec, int whichAtt) {
+		return rec.getInt (whichAtt);
+	}
+	static inline bool less (Value lhs, Value rhs) {
+		return lhs < rhs;
+	}
+};
+
+template <> struct MyDB_TypedAtt <double> {
+	typedef double Value;
+	static constexpr MyDB_AttKind kind = DoubleAtt;
+	static constexpr size_t fixedSize = sizeof (double);
+	static constexpr size_t numStrings = 0;
+	static inline Value read (const char *rec, size_t where, size_t) {
+		return *((double *) (rec + where));
+	}
+	static inline void write (char *rec, size_t where, size_t, Value val, size_t &) {
+		*((double *) (rec + where)) = val;
+	}
+	static inline size_t extraBytes (Value) {
+		return 0;
+	}
+	static inline Value fromRecord (MyDB_Record &rec, int whichAtt) {
+		return rec.getDouble (whichAtt);
+	}
+	static inline bool less (Value lhs, Value rhs) {
+		return lhs < rhs;
+	}
+};
+
+template <> struct MyDB_TypedAtt <bool> {
+	typedef bool Value;
+	static constexpr MyDB_AttKind kind = BoolAtt;
+	static constexpr size_t fixedSize = sizeof (char);
+	static constexpr size_t numStrings = 0;
+	static inline Value read (const char *rec, size_t where, size_t) {
+		return rec[where] == 1;
+	}
+	static inline void write (char *rec, size_t where, size_t, Value val, size_t &) {
+		rec[where] = val ? 1 : 0;
+	}
+	static inline size_t extraBytes (Value) {
+		return 0;
+	}
+	static inline Value fromRecord (MyDB_Record &rec, int whichAtt) {
+		return rec.getBool (whichAtt);
+	}
+	static inline bool less (Value lhs, Value rhs) {
+		return lhs < rhs;
+	}
+};
+
+// the bytes of a string go after the string table, which has the offset of each of them
+template <> struct MyDB_TypedAtt <string> {
+	typedef const char *Value;
+	static constexpr MyDB_AttKind kind = StringAtt;
+	static constexpr size_t fixedSize = 0;
+	static constexpr size_t numStrings = 1;
+	static inline Value read (const char *rec, size_t where, size_t stringTable) {
+		return rec + ((unsigned short *) (rec + stringTable))[where];
+	}
+	static inline void write (char *rec, size_t where, size_t stringTable, Value val, size_t &used) {
+		size_t len = strlen (val) + 1;
+		memcpy (rec + used, val, len);
+		((unsigned short *) (rec + stringTable))[where] = (unsigned short) used;
+		used += len;
+	}
+	static inline size_t extraBytes (Value val) {
+		return strlen (val) + 1;
+	}
+	static inline Value fromRecord (MyDB_Record &rec, int whichAtt) {
+		return rec.getChars (whichAtt);
+	}
+	static inline bool less (Value lhs, Value rhs) {
+		return strcmp (lhs, rhs) < 0;
+	}
+};
+
+// the sizes of the fixed section and the string table for a list of attributes
+template <typename... Ts> struct MyDB_TypedSizes;
+
+template <> struct MyDB_TypedSizes <> {
+	static constexpr size_t fixedSize = 0;
+	static constexpr size_t numStrings = 0;
+};
+
+template <typename T, typename... Rest> struct MyDB_TypedSizes <T, Rest...> {
+	static constexpr size_t fixedSize = MyDB_TypedAtt <T> :: fixedSize + MyDB_TypedSizes <Rest...> :: fixedSize;
+	static constexpr size_t numStrings = MyDB_TypedAtt <T> :: numStrings + MyDB_TypedSizes <Rest...> :: numStrings;
+};
+
+// the i^th attribute in a list of attributes, and where it goes
+template <size_t i, typename... Ts> struct MyDB_TypedAttAt;
+
+template <typename T, typename... Rest> struct MyDB_TypedAttAt <0, T, Rest...> {
+	typedef T Type;
+	static constexpr size_t fixedBefore = 0;
+	static constexpr size_t stringsBefore = 0;
+};
+
+template <size_t i, typename T, typename... Rest> struct MyDB_TypedAttAt <i, T, Rest...> {
+	typedef typename MyDB_TypedAttAt <i - 1, Rest...> :: Type Type;
+	static constexpr size_t fixedBefore = MyDB_TypedAtt <T> :: fixedSize + MyDB_TypedAttAt <i - 1, Rest...> :: fixedBefore;
+	static constexpr size_t stringsBefore = MyDB_TypedAtt <T> :: numStrings + MyDB_TypedAttAt <i - 1, Rest...> :: stringsBefore;
+};
+
+// the list of numbers 0, 1, ..., n - 1, for going through the attributes of a record all at once
+template <size_t... is> struct MyDB_TypedIndices {};
+
+template <size_t n, size_t... is> struct MyDB_MakeTypedIndices : MyDB_MakeTypedIndices <n - 1, n - 1, is...> {};
+
+template <size_t... is> struct MyDB_MakeTypedIndices <0, is...> {
+	typedef MyDB_TypedIndices <is...> Type;
+};
+
+template <typename... Ts>
+class MyDB_TypedRecord {
+
+public:
+
+	// the number of attributes
+	static constexpr size_t numAtts = sizeof... (Ts);
+
+	// where the string table starts, and the size of a record without its strings' bytes
+	static constexpr size_t stringTableOffset = sizeof (short) + MyDB_TypedSizes <Ts...> :: fixedSize;
+	static constexpr size_t minSize = stringTableOffset + MyDB_TypedSizes <Ts...> :: numStrings * sizeof (unsigned short);
+
+	// the type of the i^th attribute's value
+	template <size_t i> using Value = typename MyDB_TypedAtt <typename MyDB_TypedAttAt <i, Ts...> :: Type> :: Value;
+
+	// the offset of the i^th attribute (or its slot in the string table, for a string)
+	template <size_t i>
+	static constexpr size_t where () {
+		return MyDB_TypedAtt <typename MyDB_TypedAttAt <i, Ts...> :: Type> :: numStrings == 1 ?
+			MyDB_TypedAttAt <i, Ts...> :: stringsBefore :
+			sizeof (short) + MyDB_TypedAttAt <i, Ts...> :: fixedBefore;
+	}
+
+	// the i^th attribute of the record at rec
+	template <size_t i>
+	static inline Value <i> get (const void *rec) {
+		return MyDB_TypedAtt <typename MyDB_TypedAttAt <i, Ts...> :: Type> :: read ((const char *) rec, where <i> (),
+			stringTableOffset);
+	}
+
+	// true if the i^th attribute of the record at lhs is less than that of the record at rhs
+	template <size_t i>
+	static inline bool less (const void *lhs, const void *rhs) {
+		return MyDB_TypedAtt <typename MyDB_TypedAttAt <i, Ts...> :: Type> :: less (get <i> (lhs), get <i> (rhs));
+	}
+
+	// true if the record at rec is in the format that typed records use, and not the old (v1) one;
+	// get and less can only look at such records
+	static inline bool readable (const void *rec) {
+		return *((const short *) rec) < 0;
+	}
+
+	// true if the schema has exactly these attributes, so that its records can be read this way
+	static bool matches (MyDB_SchemaPtr schema) {
+		MyDB_AttKind kinds[] = {MyDB_TypedAtt <Ts> :: kind...};
+		if (schema->getAtts ().size () != numAtts)
+			return false;
+		for (size_t i = 0; i < numAtts; i++) {
+			if (schema->getAtts ()[i].second->getKind () != kinds[i])
+				return false;
+		}
+		return true;
+	}
+
+	// an empty record
+	MyDB_TypedRecord () {
+		base = nullptr;
+	}
+
+	// the i^th attribute of this record
+	template <size_t i>
+	inline Value <i> get () {
+		return get <i> (base);
+	}
+
+	// makes this record a read-only view of the record at startPos, which must stay put until this
+	// record is read again; returns the location of the next record.  This is the same as
+	// MyDB_Record :: viewBinary
+	inline void *viewBinary (void *startPos) {
+		base = (char *) startPos;
+		short header = *((short *) base);
+		if (header > 0) {
+			cout << "Can't read a record in the old format as a typed record!!\n";
+			exit (1);
+		}
+		return base - header;
+	}
+
+	// same, but the record is copied
+	void *fromBinary (void *startPos) {
+		short header = *((short *) startPos);
+		bytes.resize (header < 0 ? -header : header);
+		memcpy (bytes.data (), startPos, bytes.size ());
+		viewBinary (bytes.data ());
+		return ((char *) startPos) + bytes.size ();
+	}
+
+	// sets all of the attributes at once; the record then has its own copy of its bytes
+	void set (typename MyDB_TypedAtt <Ts> :: Value... vals) {
+		size_t size = minSize + extraBytes <0> (vals...);
+		bytes.resize (size);
+		*((short *) bytes.data ()) = - (short) size;
+		size_t used = minSize;
+		writeAtts <0> (used, vals...);
+		base = bytes.data ();
+	}
+
+	// sets all of the attributes from a MyDB_Record with a schema that matches this one; this is
+	// how a record in the old (v1) format, which can't be viewed, is read
+	void fromRecord (MyDB_Record &rec) {
+		fromRecord (rec, typename MyDB_MakeTypedIndices <numAtts> :: Type ());
+	}
+
+	// the number of bytes that the record takes up
+	inline size_t getBinarySize () {
+		return - *((short *) base);
+	}
+
+	// the record's bytes
+	inline void *getBinary () {
+		return base;
+	}
+
+	// writes the record to toHere, and returns the location of the next byte
+	void *toBinary (void *toHere) {
+		memcpy (toHere, base, getBinarySize ());
+		return ((char *) toHere) + getBinarySize ();
+	}
+
+private:
+
+	// helper for fromRecord
+	template <size_t... is>
+	void fromRecord (MyDB_Record &rec, MyDB_TypedIndices <is...>) {
+		set (MyDB_TypedAtt <Ts> :: fromRecord (rec, is)...);
+	}
+
+	// helpers for set
+	template <size_t i>
+	static size_t extraBytes () {
+		return 0;
+	}
+
+	template <size_t i, typename V, typename... Vs>
+	static size_t extraBytes (V val, Vs... rest) {
+		return MyDB_TypedAtt <typename MyDB_TypedAttAt <i, Ts...> :: Type> :: extraBytes (val) + extraBytes <i + 1> (rest...);
+	}
+
+	template <size_t i>
+	void writeAtts (size_t &) {}
+
+	template <size_t i, typename V, typename... Vs>
+	void writeAtts (size_t &used, V val, Vs... rest) {
+		MyDB_TypedAtt <typename MyDB_TypedAttAt <i, Ts...> :: Type> :: write (bytes.data (), where <i> (), stringTableOffset,
+			val, used);
+		writeAtts <i + 1> (used, rest...);
+	}
+
+	// where the record is: the bytes viewed, or our own copy of them
+	char *base;
+	vector <char> bytes;
+};
+
+// compares two records of type Rec by their i^th attribute, where they are (typically, on a page):
+// comparator (lhs, rhs) is true if the record at lhs is less than the one at rhs.  This can be given
+// to MyDB_PageReaderWriter :: sort and sortInPlace, and to the TPMMS in Sorting.h, in place of a
+// comparator from buildRecordComparator... for example, sorting the index/value table on its value is
+//
+//	sort (64, indexValueTable, sortedTable, MyDB_TypedComparator <IndexValueRec, 1> (), rec1, rec2);
+//
+// The records must be in the format that typed records use (see Rec :: readable); the sorts check this
+template <class Rec, size_t i>
+class MyDB_TypedComparator {
+
+public:
+
+	inline bool operator () (const void *lhs, const void *rhs) const {
+		return Rec :: template less <i> (lhs, rhs);
+	}
+
+	// the same comparison, over two MyDB_Records with a schema that matches Rec; records in the old
+	// (v1) format are compared through the records, as buildRecordComparator does
+	function <bool ()> over (MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) const {
+		function <bool ()> overAtts = buildRecordComparator (lhs, rhs, "[" + lhs->getSchema ()->getAtts ()[i].first + "]");
+		return [lhs, rhs, overAtts] {
+			void *lhsBytes = lhs->getBinary ();
+			void *rhsBytes = rhs->getBinary ();
+			if (Rec :: readable (lhsBytes) && Rec :: readable (rhsBytes))
+				return Rec :: template less <i> (lhsBytes, rhsBytes);
+			return overAtts ();
+		};
+	}
+};
+
+#endif
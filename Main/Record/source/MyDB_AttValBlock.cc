@@ -0,0 +1,39 @@
+
+#ifndef ATT_VAL_BLOCK_C
+#define ATT_VAL_BLOCK_C
+
+#include "MyDB_AttValBlock.h"
+
+using namespace std;
+
+MyDB_AttValBlock :: MyDB_AttValBlock (size_t numInts, size_t numDoubles, size_t numStrings, size_t numBools) :
+	ints (numInts), doubles (numDoubles), strings (numStrings), bools (numBools) {}
+
+void MyDB_AttValBlock :: fill (MyDB_RecordLayout &layout, vector <MyDB_AttValPtr> &values) {
+
+	// count up the values of each type
+	size_t counts[4] = {0, 0, 0, 0};
+	for (size_t i = 0; i < layout.getNumAtts (); i++)
+		counts[layout.getAtt (i).kind]++;
+
+	shared_ptr <MyDB_AttValBlock> block = make_shared <MyDB_AttValBlock> (counts[IntAtt], counts[DoubleAtt],
+		counts[StringAtt], counts[BoolAtt]);
+
+	// and then hand them out in order; each pointer shares the block, rather than owning its value
+	size_t used[4] = {0, 0, 0, 0};
+	values.reserve (values.size () + layout.getNumAtts ());
+	for (size_t i = 0; i < layout.getNumAtts (); i++) {
+		MyDB_AttKind kind = layout.getAtt (i).kind;
+		size_t which = used[kind]++;
+		if (kind == IntAtt)
+			values.push_back (MyDB_AttValPtr (block, &block->ints[which]));
+		else if (kind == DoubleAtt)
+			values.push_back (MyDB_AttValPtr (block, &block->doubles[which]));
+		else if (kind == StringAtt)
+			values.push_back (MyDB_AttValPtr (block, &block->strings[which]));
+		else
+			values.push_back (MyDB_AttValPtr (block, &block->bools[which]));
+	}
+}
+
+#endif
@@ -2,13 +2,29 @@
 #ifndef RECORD_CC
 #define RECORD_CC
 
+#include "MyDB_AttValBlock.h"
 #include "MyDB_Record.h"
 #include "MyDB_Schema.h"
+#include <algorithm>
 #include <iostream>
 #include <string.h>
 
 using namespace std;
 
+// the value computed by a computation, without a virtual call... this is only for a computation
+// of exactly that type, since a computation over ints always gives back a MyDB_IntAttVal, and so on
+static inline int intOf (const MyDB_AttValPtr &val) {
+	return static_cast <MyDB_IntAttVal *> (val.get ())->get ();
+}
+
+static inline double doubleOf (const MyDB_AttValPtr &val) {
+	return static_cast <MyDB_DoubleAttVal *> (val.get ())->get ();
+}
+
+static inline const char *charsOf (const MyDB_AttValPtr &val) {
+	return static_cast <MyDB_StringAttVal *> (val.get ())->getChars ();
+}
+
 char *MyDB_Record :: findsymbol (char val, char *input) {
 	while (*input != val) {
 		input++;
@@ -391,9 +407,9 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 
 pair <func, MyDB_AttTypePtr> MyDB_Record :: fromData (string attName) {
 
-	// just return a particular attribute
+	// just return a particular attribute, finding it in the record the first time that it is used
 	auto whichAtt = mySchema->getAttByName (attName);
-	return make_pair ([this, whichAtt] {return values[whichAtt.first];}, whichAtt.second);		
+	return make_pair ([this, whichAtt] {resolve (whichAtt.first); return values[whichAtt.first];}, whichAtt.second);		
 }
 
 pair <func, MyDB_AttTypePtr> MyDB_Record :: plus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
@@ -542,6 +558,11 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: gt (pair <func, MyDB_AttTypePtr> lhs
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
 		scratch.push_back (temp);
 
+		// two ints are read without a virtual call
+		if (lhs.second->getKind () == IntAtt && rhs.second->getKind () == IntAtt)
+			return make_pair ([temp, lhs, rhs] {temp->set (intOf (lhs.first ()) > intOf (rhs.first ())); return temp;},
+				make_shared <MyDB_BoolAttType> ());
+
 		// returns a lambda that computes the result
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () > rhs.first ()->toInt ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
@@ -551,6 +572,11 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: gt (pair <func, MyDB_AttTypePtr> lhs
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
 		scratch.push_back (temp);
 
+		// as are two doubles
+		if (lhs.second->getKind () == DoubleAtt && rhs.second->getKind () == DoubleAtt)
+			return make_pair ([temp, lhs, rhs] {temp->set (doubleOf (lhs.first ()) > doubleOf (rhs.first ())); return temp;},
+				make_shared <MyDB_BoolAttType> ());
+
 		// returns a lambda that computes the result
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () > rhs.first ()->toDouble ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
@@ -560,6 +586,11 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: gt (pair <func, MyDB_AttTypePtr> lhs
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
 		scratch.push_back (temp);
 
+		// two strings are compared where they are, rather than copied
+		if (lhs.second->getKind () == StringAtt && rhs.second->getKind () == StringAtt)
+			return make_pair ([temp, lhs, rhs] {temp->set (strcmp (charsOf (lhs.first ()), charsOf (rhs.first ())) > 0); return temp;},
+				make_shared <MyDB_BoolAttType> ());
+
 		// returns a lambda that computes the result
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () > rhs.first ()->toString ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
@@ -577,6 +608,11 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: lt (pair <func, MyDB_AttTypePtr> lhs
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
 		scratch.push_back (temp);
 
+		// two ints are read without a virtual call
+		if (lhs.second->getKind () == IntAtt && rhs.second->getKind () == IntAtt)
+			return make_pair ([temp, lhs, rhs] {temp->set (intOf (lhs.first ()) < intOf (rhs.first ())); return temp;},
+				make_shared <MyDB_BoolAttType> ());
+
 		// returns a lambda that computes the result
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () < rhs.first ()->toInt ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
@@ -586,6 +622,11 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: lt (pair <func, MyDB_AttTypePtr> lhs
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
 		scratch.push_back (temp);
 
+		// as are two doubles
+		if (lhs.second->getKind () == DoubleAtt && rhs.second->getKind () == DoubleAtt)
+			return make_pair ([temp, lhs, rhs] {temp->set (doubleOf (lhs.first ()) < doubleOf (rhs.first ())); return temp;},
+				make_shared <MyDB_BoolAttType> ());
+
 		// returns a lambda that computes the result
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () < rhs.first ()->toDouble ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
@@ -595,6 +636,11 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: lt (pair <func, MyDB_AttTypePtr> lhs
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
 		scratch.push_back (temp);
 
+		// two strings are compared where they are, rather than copied
+		if (lhs.second->getKind () == StringAtt && rhs.second->getKind () == StringAtt)
+			return make_pair ([temp, lhs, rhs] {temp->set (strcmp (charsOf (lhs.first ()), charsOf (rhs.first ())) < 0); return temp;},
+				make_shared <MyDB_BoolAttType> ());
+
 		// returns a lambda that computes the result
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () < rhs.first ()->toString ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
@@ -638,6 +684,11 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: eq (pair <func, MyDB_AttTypePtr> lhs
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
 		scratch.push_back (temp);
 
+		// two strings are compared where they are, rather than copied
+		if (lhs.second->getKind () == StringAtt && rhs.second->getKind () == StringAtt)
+			return make_pair ([temp, lhs, rhs] {temp->set (strcmp (charsOf (lhs.first ()), charsOf (rhs.first ())) == 0); return temp;},
+				make_shared <MyDB_BoolAttType> ());
+
 		// returns a lambda that computes the result
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () == rhs.first ()->toString ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
@@ -681,6 +732,11 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: neq (pair <func, MyDB_AttTypePtr> lh
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
 		scratch.push_back (temp);
 
+		// two strings are compared where they are, rather than copied
+		if (lhs.second->getKind () == StringAtt && rhs.second->getKind () == StringAtt)
+			return make_pair ([temp, lhs, rhs] {temp->set (strcmp (charsOf (lhs.first ()), charsOf (rhs.first ())) != 0); return temp;},
+				make_shared <MyDB_BoolAttType> ());
+
 		// returns a lambda that computes the result
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () != rhs.first ()->toString ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
@@ -754,12 +810,99 @@ void MyDB_Record :: recordContentHasChanged () {
 	bufferOld = true;
 }
 
+bool MyDB_Record :: usesLayout () {
+	return mySchema != nullptr && mySchema->getLayout ().getNumAtts () == values.size ();
+}
+
+void MyDB_Record :: pointAttAtBuffer (size_t whichAtt) const {
+	MyDB_RecordLayout &layout = mySchema->getLayout ();
+	MyDB_AttLayout &att = layout.getAtt (whichAtt);
+	if (att.kind == StringAtt) {
+		unsigned short *stringTable = (unsigned short *) (base + layout.getStringTableOffset ());
+		values[whichAtt]->setBuffered (base + stringTable[att.offset]);
+	} else {
+		values[whichAtt]->setBuffered (base + att.offset);
+	}
+	pointedAt[whichAtt] = numRead;
+}
+
+void MyDB_Record :: resolveAll () const {
+	for (size_t i = 0; i < pointedAt.size (); i++)
+		resolve (i);
+}
+
+void MyDB_Record :: markResolved () {
+	fill (pointedAt.begin (), pointedAt.end (), numRead);
+}
+
 void MyDB_Record :: writeAttsToBuffer () {
-	recSize = sizeof (short);
-	for (MyDB_AttValPtr temp : values) {
-		temp->serialize (buffer, allocatedSize, recSize);
-	}		
-	*((short *) buffer) = (short) recSize;
+
+	// a record that does not match its schema (like a B+-Tree internal record) uses the
+	// old format, where each attribute has its size in front of it
+	if (!usesLayout ()) {
+		recSize = sizeof (short);
+		for (MyDB_AttValPtr temp : values) {
+			temp->serialize (buffer, allocatedSize, recSize);
+		}		
+		*((short *) buffer) = (short) recSize;
+		base = buffer;
+		setUpAtts (recSize);
+		bufferOld = false;
+		return;
+	}
+
+	// the attributes that were never looked at have not been found in the record's bytes yet
+	resolveAll ();
+
+	// otherwise, the fixed-size attributes go at their offsets, and the strings at the end...
+	// the strings are copied out first, since some of them may still be in the buffer, where
+	// the ones before them (if they changed size) would be written over them
+	MyDB_RecordLayout &layout = mySchema->getLayout ();
+	strings.resize (layout.getNumStrings ());
+	size_t totSize = layout.getMinSize ();
+	for (size_t i = 0; i < values.size (); i++) {
+		MyDB_AttLayout &att = layout.getAtt (i);
+		if (att.kind == StringAtt) {
+			strings[att.offset] = values[i]->toString ();
+			totSize += strlen (strings[att.offset].c_str ()) + 1;
+		}
+	}
+
+	// if the buffer is too small, the old one is kept around until all of the values are written
+	char *newBuffer = buffer;
+	if (totSize > allocatedSize)
+		newBuffer = new char[totSize * 2];
+
+	recSize = layout.getMinSize ();
+	unsigned short *stringTable = (unsigned short *) (newBuffer + layout.getStringTableOffset ());
+	for (size_t i = 0; i < values.size (); i++) {
+		MyDB_AttLayout &att = layout.getAtt (i);
+		if (att.kind == IntAtt) {
+			*((int *) (newBuffer + att.offset)) = values[i]->toInt ();
+		} else if (att.kind == DoubleAtt) {
+			*((double *) (newBuffer + att.offset)) = values[i]->toDouble ();
+		} else if (att.kind == BoolAtt) {
+			*(newBuffer + att.offset) = values[i]->toBool () ? 1 : 0;
+		} else {
+			size_t len = strlen (strings[att.offset].c_str ()) + 1;
+			memcpy (newBuffer + recSize, strings[att.offset].c_str (), len);
+			stringTable[att.offset] = (unsigned short) recSize;
+			recSize += len;
+		}
+	}
+	*((short *) newBuffer) = - (short) recSize;
+
+	if (newBuffer != buffer) {
+		delete [] buffer;
+		buffer = newBuffer;
+		allocatedSize = totSize * 2;
+	}
+
+	// the values may have been in the old buffer, or somewhere else in this one
+	base = buffer;
+	pointedAt.resize (values.size (), numRead);
+	for (size_t i = 0; i < values.size (); i++)
+		pointAttAtBuffer (i);
 	bufferOld = false;
 }
 
@@ -769,13 +912,22 @@ void *MyDB_Record :: toBinary (void *toHere) {
 	if (bufferOld) {
 		writeAttsToBuffer ();
 	} 
-	memcpy (toHere, buffer, recSize);
+	memcpy (toHere, base, recSize);
 	return ((char *) toHere) + recSize;
 }
 
+void *MyDB_Record :: getBinary () {
+	if (bufferOld) {
+		writeAttsToBuffer ();
+	}
+	return base;
+}
+
 void *MyDB_Record :: fromBinary (void *fromHere) {
 
-	recSize = *((short *) fromHere);
+	// a negative size means that the record is in the new format
+	short header = *((short *) fromHere);
+	recSize = header < 0 ? -header : header;
 
 	// if our buffer is not large enough, reallocate
 	if (recSize > allocatedSize) {
@@ -787,17 +939,49 @@ void *MyDB_Record :: fromBinary (void *fromHere) {
 
 	// copy over
 	memcpy (buffer, fromHere, recSize);
+	base = buffer;
+	setUpAtts (header);
+	bufferOld = false;
 
-	// and set up the attributes
-	char *recLoc = buffer + sizeof (short);
-	for (MyDB_AttValPtr temp : values) {
-		recLoc = temp->fromBinary (recLoc);
-	}		
+	return ((char *) fromHere) + recSize;
 
+}
+
+void *MyDB_Record :: viewBinary (void *fromHere) {
+
+	// same as fromBinary, except that the bytes stay where they are
+	short header = *((short *) fromHere);
+	recSize = header < 0 ? -header : header;
+	base = (char *) fromHere;
+	setUpAtts (header);
 	bufferOld = false;
 
 	return ((char *) fromHere) + recSize;
+}
+
+void MyDB_Record :: setUpAtts (short header) {
 
+	// in the old format, each attribute is found by walking past the ones before it
+	if (header > 0) {
+		char *recLoc = base + sizeof (short);
+		for (MyDB_AttValPtr &temp : values) {
+			recLoc = temp->fromBinary (recLoc);
+		}		
+		numRead++;
+		markResolved ();
+
+	// and in the new one, each is at a known spot (or has its spot in the string table), and
+	// so it is not looked up until it is used
+	} else {
+		if (!usesLayout ()) {
+			cout << "Can't read a record that was not written with this record's schema!!\n";
+			exit (1);
+		}
+		pointedAt.resize (values.size (), numRead);
+		numRead++;
+		if (!lazy)
+			resolveAll ();
+	}
 }
 
 void MyDB_Record :: fromString (string res) {	
@@ -806,10 +990,12 @@ void MyDB_Record :: fromString (string res) {
                 string temp = res.substr (pos, res.find ("|", pos + 1) - pos);
 		values[i++]->fromString (temp);
         }
+	markResolved ();
 	bufferOld = true;
 }
 
 std::ostream& operator<<(std::ostream& os, const MyDB_Record printMe) {
+	printMe.resolveAll ();
 	for (MyDB_AttValPtr temp : printMe.values) {
 		os << temp->toString () << "|";
 	}
@@ -819,6 +1005,7 @@ std::ostream& operator<<(std::ostream& os, const MyDB_Record printMe) {
 std::ostream& operator<<(std::ostream& os, const MyDB_RecordPtr printMe) {
 	if (printMe == nullptr)
 		return os;
+	printMe->resolveAll ();
 	for (MyDB_AttValPtr temp : printMe->values) {
 		os << temp->toString () << "|";
 	}
@@ -845,13 +1032,22 @@ MyDB_Record :: MyDB_Record (MyDB_SchemaPtr mySchemaIn) {
 	mySchema = mySchemaIn;
 
 	buffer = new char[256];
+	base = buffer;
 	allocatedSize = 256;
 	recSize = 0;
 	bufferOld = true;
+	numRead = 0;
+	lazy = true;
 
 	if (mySchemaIn == nullptr)
 		return;
 
+	// the values all go in one block, unless the layout is somehow out of step with the schema
+	if (mySchema->getLayout ().getNumAtts () == mySchema->getAtts ().size ()) {
+		MyDB_AttValBlock :: fill (mySchema->getLayout (), values);
+		return;
+	}
+
 	for (auto &val : mySchema->getAtts ()) {
 		values.push_back (val.second->createAtt ());	
 	}
@@ -862,10 +1058,19 @@ MyDB_SchemaPtr &MyDB_Record :: getSchema () {
 }
 
 MyDB_AttValPtr &MyDB_Record :: getAtt (int whichAtt) {
+	resolve (whichAtt);
 	return values[whichAtt];
 }
 
 void MyDB_Record :: buildFrom (MyDB_RecordPtr left, MyDB_RecordPtr right) {
+
+	// the attributes are shared with the two records, and so they have to be set up as soon
+	// as those records are read, rather than when this one asks for them
+	left->lazy = false;
+	left->resolveAll ();
+	right->lazy = false;
+	right->resolveAll ();
+
         vector <MyDB_AttValPtr> newValues;
         for (auto &v : left->values) {
                 newValues.push_back (v);
@@ -874,6 +1079,7 @@ void MyDB_Record :: buildFrom (MyDB_RecordPtr left, MyDB_RecordPtr right) {
                 newValues.push_back (v);
         }
         values = newValues;
+	markResolved ();
 }
 
 MyDB_Record :: ~MyDB_Record () {
@@ -10,10 +10,12 @@
 #include "MyDB_Record.h"
 #include "MyDB_Table.h"
 #include "MyDB_TableReaderWriter.h"
+#include "MyDB_TableScan.h"
 #include "MyDB_Schema.h"
 #include "QUnit.h"
 #include <cstring>
 #include <iostream>
+#include <sstream>
 #include <time.h>
 #include <unistd.h>
 #include <vector>
@@ -417,6 +419,237 @@ int main(int argc, char *argv[]) {
 		QUNIT_IS_EQUAL(counter, 10000);
 	}
 	FALLTHROUGH_INTENDED;
+	case 10:
+	{
+		// the binary record format: fixed offsets and a string table, with old records still readable
+		cout << "TEST 10..." << flush;
+		bool result = true;
+		{
+			MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema>();
+			mySchema->appendAtt(make_pair("key", make_shared <MyDB_IntAttType>()));
+			mySchema->appendAtt(make_pair("name", make_shared <MyDB_StringAttType>()));
+			mySchema->appendAtt(make_pair("acctbal", make_shared <MyDB_DoubleAttType>()));
+			mySchema->appendAtt(make_pair("active", make_shared <MyDB_BoolAttType>()));
+			mySchema->appendAtt(make_pair("comment", make_shared <MyDB_StringAttType>()));
+			if (mySchema->getAttByName("acctbal").first != 2 || mySchema->getAttByName("comment").first != 4) result = false;
+
+			cout << "write a record..." << flush;
+			MyDB_RecordPtr rec = make_shared <MyDB_Record>(mySchema);
+			rec->fromString("12|abc|3.5|true|hello|");
+
+			// size, ints, double, and bool (2 + 4 + 8 + 1), the string table (2 * 2), and the strings (4 + 6)
+			char bytes[128];
+			if (rec->getBinarySize() != 29 || (char *)rec->toBinary(bytes) != bytes + 29 || *((short *)bytes) != -29) result = false;
+
+			cout << "read it back..." << flush;
+			auto check = [&result] (MyDB_RecordPtr checkMe, string name, string comment) {
+				if (checkMe->getAtt(0)->toInt() != 12 || checkMe->getAtt(1)->toString() != name ||
+					checkMe->getAtt(2)->toDouble() != 3.5 || !checkMe->getAtt(3)->toBool() ||
+					checkMe->getAtt(4)->toString() != comment) result = false;
+			};
+			MyDB_RecordPtr rec2 = make_shared <MyDB_Record>(mySchema);
+			if ((char *)rec2->fromBinary(bytes) != bytes + 29) result = false;
+			check(rec2, "abc", "hello");
+
+			cout << "change a string..." << flush;
+			string longer = "a much longer name";
+			rec2->getAtt(1)->fromString(longer);
+			rec2->recordContentHasChanged();
+			if (rec2->getBinarySize() != 29 + 15) result = false;
+			check(rec2, longer, "hello");
+			rec2->toBinary(bytes);
+			MyDB_RecordPtr rec3 = make_shared <MyDB_Record>(mySchema);
+			rec3->fromBinary(bytes);
+			check(rec3, longer, "hello");
+
+			cout << "read an old record..." << flush;
+			char *pos = bytes;
+			auto put = [&pos] (const void *data, short len) {
+				*((short *)pos) = (short)(len + sizeof(short));
+				memcpy(pos + sizeof(short), data, len);
+				pos += len + sizeof(short);
+			};
+			int key = 12;
+			double acctbal = 3.5;
+			char active = 1;
+			pos += sizeof(short);
+			put(&key, sizeof(int));
+			put("abc", 4);
+			put(&acctbal, sizeof(double));
+			put(&active, sizeof(char));
+			put("hello", 6);
+			*((short *)bytes) = (short)(pos - bytes);
+			if ((char *)rec3->fromBinary(bytes) != pos || pos - bytes != 35) result = false;
+			check(rec3, "abc", "hello");
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 11:
+	{
+		// attributes are found in a record read from binary only when they are used
+		cout << "TEST 11..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+
+			// a computation over one attribute, and then every attribute in reverse order
+			cout << "compute over one attribute..." << flush;
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			func isLow = temp->compileComputation("< ([suppkey], int[100])");
+			MyDB_RecordIteratorPtr myIter = supplierTable.getIterator(temp);
+			int counter = 0;
+			int numLow = 0;
+			while (myIter->hasNext()) {
+				myIter->getNext();
+				if (isLow()->toBool())
+					numLow++;
+				counter++;
+				if (counter % 1000 == 1) {
+					ostringstream printed;
+					printed << temp;
+					string reverse;
+					for (int i = 6; i >= 0; i--)
+						reverse = temp->getAtt(i)->toString() + "|" + reverse;
+					if (printed.str() != reverse || temp->getAtt(0)->toInt() != counter) result = false;
+				}
+			}
+			if (counter != 10000 || numLow != 99) result = false;
+
+			// changing one attribute of a record leaves the ones that were never used alone
+			cout << "change one attribute..." << flush;
+			MyDB_RecordPtr other = supplierTable.getEmptyRecord();
+			supplierTable[0].getIterator(temp)->getNext();
+			supplierTable[0].getIterator(other)->getNext();
+			string name = "a different name";
+			temp->getAtt(1)->fromString(name);
+			temp->recordContentHasChanged();
+			char bytes[1024];
+			temp->toBinary(bytes);
+			other->fromBinary(bytes);
+			if (other->getAtt(1)->toString() != name || other->getAtt(0)->toInt() != 1 || other->getAtt(6)->toString() !=
+				"requests haggle carefully. accounts sublate finally. carefully ironic pa") result = false;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 12:
+	{
+		// records viewed where they are, rather than copied
+		cout << "TEST 12..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+
+			// a scan sees the same records as an iterator
+			cout << "scan the table..." << flush;
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			func isLow = temp->compileComputation("< ([suppkey], int[100])");
+			MyDB_TableScan scan(supplierTable, temp);
+			int counter = 0;
+			int numLow = 0;
+			long sum = 0;
+			while (scan.next()) {
+				counter++;
+				sum += temp->getAtt(0)->toInt();
+				if (isLow()->toBool())
+					numLow++;
+				if (counter == 5000 && temp->getAtt(6)->toString() !=
+					"furiously final accounts integrate final packages. furiously even pinto beans use fluffily a") result = false;
+			}
+			if (counter != 10000 || sum != 50005000 || numLow != 99) result = false;
+
+			// a view sees changes made to the bytes under it
+			cout << "view bytes..." << flush;
+			MyDB_RecordPtr other = supplierTable.getEmptyRecord();
+			supplierTable[0].getIterator(temp)->getNext();
+			char bytes[1024];
+			temp->toBinary(bytes);
+			other->viewBinary(bytes);
+			if (other->getAtt(0)->toInt() != 1) result = false;
+			int changed = 77;
+			memcpy(bytes + sizeof(short), &changed, sizeof(int));
+			other->viewBinary(bytes);
+			if (other->getAtt(0)->toInt() != 77 || other->getAtt(1)->toString() != temp->getAtt(1)->toString()) result = false;
+
+			// a scan that can't get a frame for a page stops, and says so
+			cout << "scan a full buffer..." << flush;
+			{
+				vector <MyDB_PageHandle> pins;
+				for (int i = 0; i < 16; i++)
+					pins.push_back(myMgr->getPinnedPage());
+				MyDB_TableScan fullScan(supplierTable, temp);
+				if (fullScan.next() || !fullScan.failed()) result = false;
+			}
+			MyDB_TableScan laterScan(supplierTable, temp);
+			counter = 0;
+			while (laterScan.next())
+				counter++;
+			if (counter != 10000 || laterScan.failed()) result = false;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 13:
+	{
+		// attribute values read without virtual calls or copies
+		cout << "TEST 13..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+
+			// all of a record's values are in one block, which each of them shares
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			if (temp->getAtt(0).use_count() != 7) result = false;
+
+			// the typed accessors agree with the virtual ones
+			cout << "read typed values..." << flush;
+			func isLow = temp->compileComputation("< ([name], string[Supplier#000000100])");
+			MyDB_TableScan scan(supplierTable, temp);
+			int counter = 0;
+			int numLow = 0;
+			while (scan.next()) {
+				counter++;
+				if (isLow()->toBool())
+					numLow++;
+				if (temp->getInt(0) != temp->getAtt(0)->toInt() || temp->getDouble(5) != temp->getAtt(5)->toDouble() ||
+					string(temp->getChars(6)) != temp->getAtt(6)->toString()) result = false;
+			}
+			if (counter != 10000 || numLow != 99) result = false;
+
+			// and see values that have been set
+			cout << "set values..." << flush;
+			string name = "a different name";
+			temp->getAtt(0)->fromInt(12);
+			temp->getAtt(1)->fromString(name);
+			if (temp->getInt(0) != 12 || strcmp(temp->getChars(1), name.c_str()) != 0) result = false;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
 	case 0:
 	{
 		// table hasNext with all pages cleared
@@ -10,9 +10,12 @@
 #include "MyDB_Record.h"
 #include "MyDB_Table.h"
 #include "MyDB_TableReaderWriter.h"
+#include "MyDB_TableScan.h"
+#include "MyDB_TypedRecord.h"
 #include "MyDB_Schema.h"
 #include "QUnit.h"
 #include "Sorting.h"
+#include <chrono>
 #include <iostream>
 
 
@@ -1045,6 +1048,264 @@ int main (int argc, char *argv[]) {
 		cout << endl << endl << "***FAIL****" << endl << endl << flush;
 	}		
 	
+	case 11:
+	cout << endl << "Test 11: Scan and sort with and without direct I/O:" << endl << flush;
+	countCorrect = 0;
+	for (int direct = 0; direct < 2; direct++) {
+
+		// load up the supplier table from the catalog; it is several times bigger than the buffer
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferOptions options;
+		options.directIO = direct;
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile", options);
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+		MyDB_TablePtr outTable = make_shared <MyDB_Table> ("supplierSortedDirect", "supplierSortedDirect.bin", allTables["supplier"]->getSchema ());
+		MyDB_TableReaderWriter outputTable (outTable, myMgr);
+		double megabytes = (allTables["supplier"]->lastPage () + 1) * 131072.0 / (1024 * 1024);
+		cout << (myMgr->usesDirectIO (allTables["supplier"]) ? "direct I/O.." : "buffered I/O..") << flush;
+
+		// scan it
+		MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = supplierTable.getEmptyRecord ();
+		auto t1 = chrono :: steady_clock :: now ();
+		MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt ();
+		int counter = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (rec1);
+			counter++;
+		}
+		auto t2 = chrono :: steady_clock :: now ();
+		cout << "scan " << (long) (megabytes / chrono :: duration <double> (t2 - t1).count ()) << "MB/s.." << flush;
+
+		// and sort it
+		function <bool ()> myComp = buildRecordComparator (rec1, rec2, "[acctbal]");
+		sort (64, supplierTable, outputTable, myComp, rec1, rec2);
+		auto t3 = chrono :: steady_clock :: now ();
+		cout << "sort " << (long) (megabytes / chrono :: duration <double> (t3 - t2).count ()) << "MB/s.." << endl << flush;
+
+		myIter = outputTable.getIteratorAlt ();
+		int sortedCounter = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (rec1);
+			sortedCounter++;
+		}
+		if (counter == 320000 && sortedCounter == 320000)
+			countCorrect++;
+	}
+
+	QUNIT_IS_EQUAL (countCorrect, 2);
+	if (countCorrect == 2) {
+		cout << "PASS" << endl << flush;
+	}
+	else {
+		cout << endl << endl << "***FAIL****" << endl << endl << flush;
+	}
+
+	case 12:
+	cout << endl << "Test 12: Sort with a typed record:" << endl << flush;
+	{
+		typedef MyDB_TypedRecord <int, string, string, int, string, double, string> SupplierRec;
+		countCorrect = 0;
+
+		// a typed record is written just like a MyDB_Record
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+		MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = supplierTable.getEmptyRecord ();
+		SupplierRec typed;
+		typed.set (12, "a name", "an address", 3, "a phone", 45.5, "a comment");
+		rec1->fromBinary (typed.getBinary ());
+		if (rec1->getAtt (0)->toInt () == 12 && rec1->getAtt (2)->toString () == "an address" &&
+			rec1->getAtt (5)->toDouble () == 45.5 && rec1->getAtt (6)->toString () == "a comment")
+			countCorrect++;
+
+		// scan it
+		SupplierRec current;
+		MyDB_TypedTableScan <SupplierRec> scan (supplierTable, current);
+		int counter = 0;
+		long sum = 0;
+		while (scan.next ()) {
+			sum += current.get <0> ();
+			counter++;
+		}
+
+		// sort it on acctbal, and check that the same records come out in order
+		MyDB_TablePtr outTable = make_shared <MyDB_Table> ("supplierSortedTyped", "supplierSortedTyped.bin", allTables["supplier"]->getSchema ());
+		MyDB_TableReaderWriter outputTable (outTable, myMgr);
+		double megabytes = (allTables["supplier"]->lastPage () + 1) * 131072.0 / (1024 * 1024);
+		auto t1 = chrono :: steady_clock :: now ();
+		sort (64, supplierTable, outputTable, MyDB_TypedComparator <SupplierRec, 5> (), rec1, rec2);
+		auto t2 = chrono :: steady_clock :: now ();
+		cout << "sort " << (long) (megabytes / chrono :: duration <double> (t2 - t1).count ()) << "MB/s.." << endl << flush;
+
+		MyDB_TypedTableScan <SupplierRec> sortedScan (outputTable, current);
+		int sortedCounter = 0;
+		long sortedSum = 0;
+		double last = -1e100;
+		bool inOrder = true;
+		while (sortedScan.next ()) {
+			if (current.get <5> () < last)
+				inOrder = false;
+			last = current.get <5> ();
+			sortedSum += current.get <0> ();
+			sortedCounter++;
+		}
+		if (inOrder && counter == 320000 && sortedCounter == counter && sortedSum == sum)
+			countCorrect++;
+	}
+
+	QUNIT_IS_EQUAL (countCorrect, 2);
+	if (countCorrect == 2) {
+		cout << "PASS" << endl << flush;
+	}
+	else {
+		cout << endl << endl << "***FAIL****" << endl << endl << flush;
+	}
+
+	case 13:
+	cout << endl << "Test 13: Scan and sort records in the old format with a typed record:" << endl << flush;
+	{
+		typedef MyDB_TypedRecord <int, double> IndexValueRec;
+		countCorrect = 0;
+
+		// a table with every third record in the old (v1) format, which has the size of each attribute in
+		// front of it, and so can't be read with a typed record
+		MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+		mySchema->appendAtt (make_pair ("index", make_shared <MyDB_IntAttType> ()));
+		mySchema->appendAtt (make_pair ("value", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_TablePtr myTable = make_shared <MyDB_Table> ("mixedvalue", "mixedvalue.bin", mySchema);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 16, "tempFile");
+		MyDB_TableReaderWriter mixedTable (myTable, myMgr);
+		MyDB_RecordPtr rec1 = mixedTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = mixedTable.getEmptyRecord ();
+		MyDB_RecordPtr oldRec = mixedTable.getEmptyRecord ();
+		long sum = 0;
+		for (int i = 0; i < 2000; i++) {
+			double value = (i * 7919) % 2000;
+			if (i % 3 == 0) {
+				char bytes[32];
+				char *pos = bytes + sizeof (short);
+				*((short *) pos) = sizeof (short) + sizeof (int);
+				memcpy (pos + sizeof (short), &i, sizeof (int));
+				pos += sizeof (short) + sizeof (int);
+				*((short *) pos) = sizeof (short) + sizeof (double);
+				memcpy (pos + sizeof (short), &value, sizeof (double));
+				pos += sizeof (short) + sizeof (double);
+				*((short *) bytes) = (short) (pos - bytes);
+				oldRec->fromBinary (bytes);
+				mixedTable.append (oldRec);
+			} else {
+				rec1->fromString (to_string (i) + "|" + to_string (value) + "|");
+				mixedTable.append (rec1);
+			}
+			sum += i;
+		}
+
+		// a typed scan reads them through a MyDB_Record
+		IndexValueRec current;
+		MyDB_TypedTableScan <IndexValueRec> scan (mixedTable, current);
+		int scanned = 0;
+		long scannedSum = 0;
+		bool sameValues = true;
+		while (scan.next ()) {
+			if (current.get <1> () != (current.get <0> () * 7919) % 2000)
+				sameValues = false;
+			scannedSum += current.get <0> ();
+			scanned++;
+		}
+		if (sameValues && scanned == 2000 && scannedSum == sum && !scan.failed ())
+			countCorrect++;
+
+		// the typed comparator can't sort a page of them
+		MyDB_PageReaderWriter firstPage = mixedTable[0];
+		if (firstPage.sort (MyDB_TypedComparator <IndexValueRec, 1> ()) == nullptr &&
+			!firstPage.sortInPlace (MyDB_TypedComparator <IndexValueRec, 1> ()))
+			countCorrect++;
+
+		// but the TPMMS still sorts them, through the records
+		MyDB_TablePtr outTable = make_shared <MyDB_Table> ("mixedvalueSorted", "mixedvalueSorted.bin", mySchema);
+		MyDB_TableReaderWriter outputTable (outTable, myMgr);
+		sort (4, mixedTable, outputTable, MyDB_TypedComparator <IndexValueRec, 1> (), rec1, rec2);
+
+		MyDB_RecordIteratorAltPtr myIter = outputTable.getIteratorAlt ();
+		int counter = 0;
+		long sortedSum = 0;
+		double last = -1;
+		bool inOrder = true;
+		while (myIter->advance ()) {
+			myIter->getCurrent (rec1);
+			if (rec1->getAtt (1)->toDouble () < last)
+				inOrder = false;
+			last = rec1->getAtt (1)->toDouble ();
+			sortedSum += rec1->getAtt (0)->toInt ();
+			counter++;
+		}
+		if (inOrder && counter == 2000 && sortedSum == sum)
+			countCorrect++;
+	}
+
+	QUNIT_IS_EQUAL (countCorrect, 3);
+	if (countCorrect == 3) {
+		cout << "PASS" << endl << flush;
+	}
+	else {
+		cout << endl << endl << "***FAIL****" << endl << endl << flush;
+	}
+
+	case 14:
+	cout << endl << "Test 14: Sort with runs as big as the buffer:" << endl << flush;
+	{
+		countCorrect = 0;
+
+		// the pages of a run are pinned together to read them in, but must not stay pinned through
+		// the merges of the run, which need frames of their own
+		MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+		mySchema->appendAtt (make_pair ("index", make_shared <MyDB_IntAttType> ()));
+		mySchema->appendAtt (make_pair ("value", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_TablePtr myTable = make_shared <MyDB_Table> ("fullrun", "fullrun.bin", mySchema);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 16, "tempFile");
+		MyDB_TableReaderWriter fullRunTable (myTable, myMgr);
+		MyDB_RecordPtr rec1 = fullRunTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = fullRunTable.getEmptyRecord ();
+		long sum = 0;
+		for (int i = 0; i < 2000; i++) {
+			rec1->fromString (to_string (i) + "|" + to_string ((i * 7919) % 2000) + "|");
+			fullRunTable.append (rec1);
+			sum += i;
+		}
+
+		MyDB_TablePtr outTable = make_shared <MyDB_Table> ("fullrunSorted", "fullrunSorted.bin", mySchema);
+		MyDB_TableReaderWriter outputTable (outTable, myMgr);
+		sort (16, fullRunTable, outputTable, buildRecordComparator (rec1, rec2, "[value]"), rec1, rec2);
+
+		MyDB_RecordIteratorAltPtr myIter = outputTable.getIteratorAlt ();
+		int counter = 0;
+		long sortedSum = 0;
+		double last = -1;
+		bool inOrder = true;
+		while (myIter->advance ()) {
+			myIter->getCurrent (rec1);
+			if (rec1->getAtt (1)->toDouble () < last)
+				inOrder = false;
+			last = rec1->getAtt (1)->toDouble ();
+			sortedSum += rec1->getAtt (0)->toInt ();
+			counter++;
+		}
+		if (inOrder && counter == 2000 && sortedSum == sum)
+			countCorrect++;
+	}
+
+	QUNIT_IS_EQUAL (countCorrect, 1);
+	if (countCorrect == 1) {
+		cout << "PASS" << endl << flush;
+	}
+	else {
+		cout << endl << endl << "***FAIL****" << endl << endl << flush;
+	}
+
 	default:
 		break;
   }
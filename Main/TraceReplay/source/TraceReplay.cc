@@ -0,0 +1,80 @@
+
+#ifndef TRACE_REPLAY_C
+#define TRACE_REPLAY_C
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include "MyDB_AccessTrace.h"
+#include "MyDB_TraceSimulator.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// plays a trace recorded by a buffer manager (see MyDB_BufferOptions.h) back against
+// each replacement policy and Belady's algorithm, at a number of buffer sizes, and
+// prints the hit rate of each.  Usage:
+//
+//	traceReplay traceFile [numFrames ...]
+//
+// if no buffer sizes are given, the sizes tried go up by doubling to the number of
+// different pages in the trace
+int main (int argc, char *argv[]) {
+
+	if (argc < 2) {
+		cout << "usage: " << argv[0] << " traceFile [numFrames ...]\n";
+		return 1;
+	}
+
+	size_t pageSize;
+	vector <MyDB_TraceEntry> entries;
+	if (!MyDB_AccessTrace :: read (argv[1], pageSize, entries)) {
+		cout << "Can't read the trace " << argv[1] << "!!\n";
+		return 1;
+	}
+	double seconds = entries.size () == 0 ? 0 : entries.back ().time / 1e9;
+	MyDB_TraceSimulator simulator (entries);
+	cout << simulator.getNumAccesses () << " accesses to " << simulator.getNumPages () << " pages of " <<
+		pageSize << " bytes over " << seconds << " seconds\n";
+	if (simulator.getNumAccesses () == 0)
+		return 0;
+
+	// figure out the buffer sizes to try
+	vector <size_t> sizes;
+	for (int i = 2; i < argc; i++) {
+		long numFrames = atol (argv[i]);
+		if (numFrames <= 0) {
+			cout << "Bad number of frames " << argv[i] << "!!\n";
+			return 1;
+		}
+		sizes.push_back (numFrames);
+	}
+	if (sizes.size () == 0) {
+		for (size_t numFrames = 1; numFrames < simulator.getNumPages (); numFrames *= 2)
+			sizes.push_back (numFrames);
+		sizes.push_back (simulator.getNumPages ());
+	}
+
+	// and try them
+	vector <pair <string, MyDB_ReplacementType>> policies = {make_pair ("CLOCK", ClockReplacement),
+		make_pair ("LRU", LRUReplacement), make_pair ("LRU-K", LRUKReplacement), make_pair ("2Q", TwoQReplacement),
+		make_pair ("ARC", ARCReplacement)};
+	cout << setw (10) << "frames";
+	for (auto &policy : policies)
+		cout << setw (10) << policy.first;
+	cout << setw (10) << "OPT" << "\n" << fixed << setprecision (4);
+	for (size_t numFrames : sizes) {
+		cout << setw (10) << numFrames;
+		for (auto &policy : policies) {
+			size_t misses = simulator.simulate (policy.second, numFrames);
+			cout << setw (10) << 1.0 - (double) misses / simulator.getNumAccesses ();
+		}
+		size_t misses = simulator.simulateOptimal (numFrames);
+		cout << setw (10) << 1.0 - (double) misses / simulator.getNumAccesses () << "\n";
+	}
+	return 0;
+}
+
+#endif
+